@@ -0,0 +1,45 @@
+#include "AssetPack.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+static void PrintUsage()
+{
+	std::cout << "usage: assetpack [directory] [output.pak]" << std::endl;
+	std::cout << "  directory    assets to pack, names keep this prefix (default res)" << std::endl;
+	std::cout << "  output.pak   archive to write (default res.pak)" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 3)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::string directory = argc > 1 ? argv[1] : "res";
+	std::string outputPath = argc > 2 ? argv[2] : "res.pak";
+
+	auto start = std::chrono::high_resolution_clock::now();
+	int count = AssetPack::Build(directory, outputPath);
+	auto end = std::chrono::high_resolution_clock::now();
+
+	if (count < 0)
+	{
+		std::cout << "failed to pack " << directory << " into " << outputPath << std::endl;
+		return 1;
+	}
+
+	AssetPack pack(outputPath);
+	if (!pack.IsOpen())
+	{
+		std::cout << "failed to read back " << outputPath << std::endl;
+		return 1;
+	}
+
+	std::cout << directory << " -> " << outputPath << ": " << count << " assets in "
+		<< std::chrono::duration<float, std::milli>(end - start).count() << " ms" << std::endl;
+	return 0;
+}
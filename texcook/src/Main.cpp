@@ -0,0 +1,88 @@
+#include "CompressedImage.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static void PrintUsage()
+{
+	std::cout << "usage: texcook [--bc1 | --bc3] [--no-mips] [--threads N] input.png [output.ctex]" << std::endl;
+	std::cout << "  --bc1        opaque images, 8 bytes per 4x4 block" << std::endl;
+	std::cout << "  --bc3        images with alpha, 16 bytes per 4x4 block (default)" << std::endl;
+	std::cout << "  --no-mips    only store level 0" << std::endl;
+	std::cout << "  --threads N  encoder threads, 0 uses every core (default)" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	BlockFormat format = BlockFormat::BC3;
+	bool mips = true;
+	unsigned int threadCount = 0;
+	std::string inputPath, outputPath;
+
+	/* Parse command line options */
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--bc1") == 0)
+			format = BlockFormat::BC1;
+		else if (strcmp(argv[i], "--bc3") == 0)
+			format = BlockFormat::BC3;
+		else if (strcmp(argv[i], "--no-mips") == 0)
+			mips = false;
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			threadCount = (unsigned int)atoi(argv[++i]);
+		else if (inputPath.empty())
+			inputPath = argv[i];
+		else if (outputPath.empty())
+			outputPath = argv[i];
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (inputPath.empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	/* Default to the input name with its extension swapped */
+	if (outputPath.empty())
+		outputPath = inputPath.substr(0, inputPath.find_last_of('.')) + ".ctex";
+
+	auto start = std::chrono::high_resolution_clock::now();
+	CompressedImage image;
+	if (!CookCompressedImage(inputPath, format, threadCount, mips, image))
+	{
+		std::cout << "failed to load " << inputPath << std::endl;
+		return 1;
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	if (!WriteCompressedImage(outputPath, image))
+	{
+		std::cout << "failed to write " << outputPath << std::endl;
+		return 1;
+	}
+
+	size_t compressedSize = 0, uncompressedSize = 0;
+	for (int level = 0, w = image.Width, h = image.Height; level < (int)image.Levels.size(); level++)
+	{
+		compressedSize += image.Levels[level].size();
+		uncompressedSize += (size_t)w * h * 4;
+		w = w > 1 ? w / 2 : 1;
+		h = h > 1 ? h / 2 : 1;
+	}
+
+	std::cout << inputPath << " -> " << outputPath << ": "
+		<< image.Width << "x" << image.Height << ", "
+		<< image.Levels.size() << " levels, "
+		<< (format == BlockFormat::BC1 ? "BC1" : "BC3") << ", "
+		<< uncompressedSize / 1024 << " KB -> " << compressedSize / 1024 << " KB in "
+		<< std::chrono::duration<float, std::milli>(end - start).count() << " ms" << std::endl;
+	return 0;
+}
@@ -3,14 +3,23 @@
 
 layout(location = 0) in vec4 position;
 layout(location = 1) in vec2 texCoord;
+#ifdef INSTANCED
+layout(location = 2) in mat4 model;		// per instance, locations 2 to 5
+#else
+uniform mat4 u_Model;
+#endif
 
 out vec2 v_TexCoord;
 
-uniform mat4 u_MVP;
+#include "include/Camera.glsl"
 
 void main()
 {
-	gl_Position = u_MVP * position;
+#ifdef INSTANCED
+	gl_Position = u_ViewProj * model * position;
+#else
+	gl_Position = u_ViewProj * u_Model * position;
+#endif
 	v_TexCoord = texCoord;
 };
 
@@ -22,10 +31,27 @@ layout(location = 0) out vec4 color;
 in vec2 v_TexCoord;
 
 uniform vec4 u_Color;
+#ifndef FLAT_COLOUR
 uniform sampler2D u_Texture;
+#endif
+#ifdef ALPHA_TEST
+uniform float u_AlphaCutoff;
+#endif
 
 void main()
 {
+#ifdef FLAT_COLOUR
+	color = u_Color;
+#else
 	vec4 texColor = texture(u_Texture, v_TexCoord);
 	color = texColor * u_Color;
+#endif
+#ifdef ALPHA_TEST
+	if (color.a < u_AlphaCutoff)
+		discard;
+#endif
+#ifdef VARIANT
+	// Only set by the Shader Library test, a slightly different tint per variant
+	color.rgb *= 1.0 - 0.02 * float(VARIANT % 16);
+#endif
 };
\ No newline at end of file
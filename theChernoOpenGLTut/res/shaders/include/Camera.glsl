@@ -0,0 +1,9 @@
+/* Per frame data shared by every shader, see Renderer::BeginFrame and Renderer::SetCamera */
+layout(std140) uniform Camera
+{
+	mat4 u_Proj;
+	mat4 u_View;
+	mat4 u_ViewProj;
+	float u_Time;
+	vec2 u_Resolution;
+};
@@ -1,7 +1,15 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "Renderer.h"
 #include "VertexBuffer.h"
@@ -10,6 +18,15 @@
 #include "VertexArray.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "StateCache.h"
+#include "AssetWatcher.h"
+#include "CpuProfiler.h"
+#include "FrameTimer.h"
+#include "Framebuffer.h"
+#include "GpuProfiler.h"
+#include "HeadlessContext.h"
+#include "ImageWriter.h"
+#include "ReadbackQueue.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -17,13 +34,273 @@
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_glfw_gl3.h"
 
-#include "tests\TestClearColour.h"
-#include "tests\TestTexture2D.h"
+#include "tests/TestClearColour.h"
+#include "tests/TestTexture2D.h"
+#include "tests/TestBatch.h"
+#include "tests/TestInstancing.h"
+#include "tests/TestShaderCache.h"
+#include "tests/TestShaderLibrary.h"
+#include "tests/TestUniforms.h"
+#include "tests/TestTextureStreaming.h"
+#include "tests/TestMipmaps.h"
+#include "tests/TestCompressedTextures.h"
+#include "tests/TestAtlas.h"
+#include "tests/TestAssetPack.h"
+#include "tests/TestShaderVariants.h"
+#include "tests/TestRenderToTexture.h"
+#include "tests/TestInterpolation.h"
+#include "tests/BenchmarkRunner.h"
 
-int main(void)
+/* Shared by the windowed menu and --headless */
+static void RegisterTests(test::TestMenu& menu)
+{
+	menu.RegisterTest<test::ClearColour>("Clear Colour");
+	menu.RegisterTest<test::Texture2D>("Texture 2D");
+	menu.RegisterTest<test::Batch>("Batch");
+	menu.RegisterTest<test::Instancing>("Instancing");
+	menu.RegisterTest<test::ShaderCache>("Shader Cache");
+	menu.RegisterTest<test::TestShaderLibrary>("Shader Library");
+	menu.RegisterTest<test::Uniforms>("Uniforms");
+	menu.RegisterTest<test::TextureStreaming>("Texture Streaming");
+	menu.RegisterTest<test::Mipmaps>("Mipmaps");
+	menu.RegisterTest<test::CompressedTextures>("Compressed Textures");
+	menu.RegisterTest<test::Atlas>("Atlas");
+	menu.RegisterTest<test::TestAssetPack>("Asset Pack");
+	menu.RegisterTest<test::ShaderVariants>("Shader Variants");
+	menu.RegisterTest<test::RenderToTexture>("Render To Texture");
+	menu.RegisterTest<test::Interpolation>("Interpolation");
+}
+
+/* Frames recorded by the CPU trace hotkey, written to s_TracePath */
+static const int s_TraceFrameCount = 10;
+static const char* s_TracePath = "cache/cpu_trace.json";
+
+/* Run one test into an offscreen framebuffer through the BenchmarkRunner, printing a
+   summary of its timings and counters; the same statistics can go to JSON or CSV and
+   every measured frame to a per frame CSV ("-" writes to stdoutStream). With a capture
+   directory every measured frame is also written there as a PNG, with a trace path
+   the whole run is recorded by the CpuProfiler */
+static int RunHeadless(const std::string& testName, const test::BenchmarkSettings& settings, int width, int height, bool glDebug,
+	const std::string& captureDirectory, const std::string& tracePath,
+	const std::string& jsonPath, const std::string& csvPath, const std::string& frameCsvPath, std::ostream& stdoutStream)
+{
+	HeadlessContext context(glDebug);
+	if (!context.IsValid())
+	{
+		std::cout << "ERROR! Could not create a headless OpenGL context" << std::endl;
+		return -1;
+	}
+
+	/* Without an X display GLEW still loads every GL entry point and only fails on GLX */
+	GLenum glewStatus = glewInit();
+	if (glewStatus != GLEW_OK && glewStatus != GLEW_ERROR_NO_GLX_DISPLAY)
+	{
+		std::cout << "ERROR! GLEW IS NOT OKAY" << std::endl;
+		return -1;
+	}
+	std::cout << glGetString(GL_VERSION) << " on " << glGetString(GL_RENDERER) << " (" << context.GetBackendName() << ")" << std::endl;
+
+	if (glDebug && !GLEnableDebugOutput())
+		std::cout << "GL debug output is not supported, falling back to glGetError" << std::endl;
+
+	int result = 0;
+	{
+		GLCall(glEnable(GL_BLEND));
+		GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+
+		Renderer::Init();
+		Framebuffer framebuffer(width, height);
+
+		/* Tests still build their UI so its CPU cost is measured, nothing draws it */
+		ImGui::CreateContext();
+		ImGuiIO& io = ImGui::GetIO();
+		io.DisplaySize = ImVec2((float)width, (float)height);
+		io.IniFilename = nullptr;
+		unsigned char* fontPixels;
+		int fontWidth, fontHeight;
+		io.Fonts->GetTexDataAsRGBA32(&fontPixels, &fontWidth, &fontHeight);
+
+		test::Test* currentTest = nullptr;
+		test::TestMenu testMenu(currentTest);
+		RegisterTests(testMenu);
+
+		/* Encoding happens on the queue's worker, the frame loop only pays for starting the copy */
+		std::unique_ptr<ReadbackQueue> captureQueue;
+		if (!captureDirectory.empty())
+		{
+			std::filesystem::create_directories(captureDirectory);
+			captureQueue = std::make_unique<ReadbackQueue>(3, [captureDirectory](const ReadbackQueue::Frame& frame)
+			{
+				char name[32];
+				std::snprintf(name, sizeof(name), "/frame_%05llu.png", (unsigned long long)frame.Index);
+				if (!WritePNG(captureDirectory + name, frame.Pixels.data(), frame.Width, frame.Height))
+					std::cout << "Warning: could not write " << captureDirectory << name << std::endl;
+			});
+		}
+
+		CpuProfiler::SetThreadName("Main");
+		if (!tracePath.empty())
+			CpuProfiler::Start();
+
+		test::BenchmarkRunner runner(testMenu, framebuffer, settings);
+		bool ran = runner.Run(testName, [&](int frame)
+		{
+			if (captureQueue)
+			{
+				captureQueue->Capture(framebuffer);
+				captureQueue->Update();
+			}
+		});
+
+		if (!tracePath.empty())
+		{
+			CpuProfiler::Stop();
+			if (CpuProfiler::WriteChromeTrace(tracePath))
+				std::cout << "Wrote CPU trace to " << tracePath << std::endl;
+			else
+				std::cout << "Warning: could not write CPU trace to " << tracePath << std::endl;
+		}
+		if (captureQueue)
+		{
+			captureQueue->Flush();
+			ReadbackQueue::Stats captureStats = captureQueue->GetStats();
+			std::cout << "Captured " << captureStats.Delivered << " frames to " << captureDirectory
+				<< ", " << captureStats.Dropped << " dropped" << std::endl;
+		}
+
+		if (!ran)
+		{
+			std::cout << "ERROR! No test called '" << testName << "', the tests are:" << std::endl;
+			for (const std::string& name : testMenu.GetTestNames())
+				std::cout << "  " << name << std::endl;
+			result = -1;
+		}
+		else
+		{
+			runner.PrintSummary(std::cout);
+
+			auto writeReport = [&stdoutStream](const std::string& path, const char* what, auto write)
+			{
+				if (path.empty())
+					return true;
+				if (path == "-")
+				{
+					write(stdoutStream);
+					stdoutStream.flush();
+					return true;
+				}
+				std::ofstream stream(path);
+				if (stream)
+					write(stream);
+				if (!stream)
+				{
+					std::cout << "Warning: could not write " << what << " to " << path << std::endl;
+					return false;
+				}
+				std::cout << "Wrote " << what << " to " << path << std::endl;
+				return true;
+			};
+			bool written = writeReport(jsonPath, "JSON report", [&](std::ostream& stream) { runner.WriteJSON(stream); });
+			written &= writeReport(csvPath, "CSV report", [&](std::ostream& stream) { runner.WriteCSV(stream); });
+			written &= writeReport(frameCsvPath, "per frame CSV", [&](std::ostream& stream) { runner.WriteFrameCSV(stream); });
+			if (!written)
+				result = -1;
+		}
+
+		Renderer::Shutdown();
+		ImGui::DestroyContext();
+	}
+	return result;
+}
+
+static void PrintUsage(const char* program)
+{
+	std::cout << "Usage: " << program << " [--gl-debug] [--pacing uncapped|vsync|<fps>]\n"
+		<< "       " << program << " --headless <test name> [--frames N] [--warmup N] [--width W] [--height H]\n"
+		<< "           [--capture <directory>] [--trace <file>] [--json <file>|-] [--csv <file>|-] [--frame-csv <file>|-]"
+		<< std::endl;
+}
+
+int main(int argc, char** argv)
 {
 	GLFWwindow* window;
 
+	/* Parse command line options */
+	bool glDebug = false;
+	bool headless = false;
+	std::string headlessTest;
+	test::BenchmarkSettings benchmarkSettings;
+	int headlessWidth = 960, headlessHeight = 540;
+	std::string captureDirectory;
+	std::string tracePath;
+	std::string jsonPath, csvPath, frameCsvPath;
+	FramePacing pacing = FramePacing::VSync;
+	int frameLimit = 144;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--gl-debug") == 0)
+			glDebug = true;
+		else if (strcmp(argv[i], "--headless") == 0)
+		{
+			/* Falling through to the window would hang a build server waiting on nobody */
+			if (i + 1 == argc)
+			{
+				PrintUsage(argv[0]);
+				return -1;
+			}
+			headless = true;
+			headlessTest = argv[++i];
+		}
+		else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+			benchmarkSettings.MeasuredFrames = std::max(1, atoi(argv[++i]));
+		else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+			benchmarkSettings.WarmupFrames = std::max(0, atoi(argv[++i]));
+		else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc)
+			headlessWidth = std::max(1, atoi(argv[++i]));
+		else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc)
+			headlessHeight = std::max(1, atoi(argv[++i]));
+		else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+			captureDirectory = argv[++i];
+		else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+			tracePath = argv[++i];
+		else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (strcmp(argv[i], "--frame-csv") == 0 && i + 1 < argc)
+			frameCsvPath = argv[++i];
+		else if (strcmp(argv[i], "--pacing") == 0 && i + 1 < argc)
+		{
+			/* uncapped, vsync or a frame limit in frames per second */
+			const char* mode = argv[++i];
+			if (strcmp(mode, "uncapped") == 0)
+				pacing = FramePacing::Uncapped;
+			else if (strcmp(mode, "vsync") == 0)
+				pacing = FramePacing::VSync;
+			else if (atoi(mode) > 0)
+			{
+				pacing = FramePacing::Limited;
+				frameLimit = atoi(mode);
+			}
+		}
+	}
+
+	/* No window at all, e.g. on build servers: --headless "Batch" --frames 300 --json cache/batch.json */
+	if (headless)
+	{
+		/* A report written to stdout has to be the only thing there, so everything else
+		   printed through std::cout, the summary and any warnings, goes to stderr */
+		std::streambuf* stdoutBuffer = std::cout.rdbuf();
+		std::ostream stdoutStream(stdoutBuffer);
+		if (jsonPath == "-" || csvPath == "-" || frameCsvPath == "-")
+			std::cout.rdbuf(std::cerr.rdbuf());
+
+		int result = RunHeadless(headlessTest, benchmarkSettings, headlessWidth, headlessHeight, glDebug,
+			captureDirectory, tracePath, jsonPath, csvPath, frameCsvPath, stdoutStream);
+		std::cout.rdbuf(stdoutBuffer);
+		return result;
+	}
+
 	/* Initialize the library */
 	if (!glfwInit())
 		return -1;
@@ -32,6 +309,8 @@ int main(void)
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	if (glDebug)
+		glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
 
 	/* Create a windowed mode window and its OpenGL context */
 	window = glfwCreateWindow(960, 540, "Hello World", NULL, NULL);
@@ -44,8 +323,8 @@ int main(void)
 	/* Make the window's context current */
 	glfwMakeContextCurrent(window);
 
-	/* Lock Framerate */
-	glfwSwapInterval(1);
+	/* Only VSync waits in glfwSwapBuffers, Limited waits in FrameTimer::Tick */
+	glfwSwapInterval(pacing == FramePacing::VSync ? 1 : 0);
 
 	/* Check for errors in glewinit before proceeding */
 	if (glewInit() != GLEW_OK)
@@ -53,11 +332,19 @@ int main(void)
 
 	/* output OpenGL Version Number in use */
 	std::cout << glGetString(GL_VERSION) << std::endl;
+
+	/* Swap glGetError polling for the KHR_debug callback */
+	if (glDebug && !GLEnableDebugOutput())
+		std::cout << "GL debug output is not supported, falling back to glGetError" << std::endl;
 	{
 		GLCall(glEnable(GL_BLEND));
 		GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
 
 		Renderer renderer;
+		Renderer::Init();
+
+		/* Edits under res/ are picked up while the app runs */
+		AssetWatcher assetWatcher("res");
 
 		ImGui::CreateContext();
 		ImGui_ImplGlfwGL3_Init(window, true);
@@ -66,20 +353,67 @@ int main(void)
 		test::Test* currentTest = nullptr;
 		test::TestMenu* testMenu = new test::TestMenu(currentTest);
 		currentTest = testMenu;
-		testMenu->RegisterTest<test::ClearColour>("Clear Colour");
-		testMenu->RegisterTest<test::Texture2D>("Texture 2D");
+		RegisterTests(*testMenu);
+
+		CpuProfiler::SetThreadName("Main");
+		bool traceRequested = false, traceKeyDown = false;
+
+		FrameTimer frameTimer(pacing, frameLimit);
+		FixedTimestep fixedTimestep;
 
 		/* Loop until the user closes the window */
 		while (!glfwWindowShouldClose(window))
 		{
+			/* CPU traces start and stop here, between frames, so they only hold whole frames */
+			CpuProfiler::OnFrameEnd();
+			bool traceKey = glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS;
+			if ((traceKey && !traceKeyDown) || traceRequested)
+			{
+				std::filesystem::create_directories("cache");
+				CpuProfiler::CaptureFrames(s_TraceFrameCount, s_TracePath);
+			}
+			traceKeyDown = traceKey;
+			traceRequested = false;
+
+			float deltaTime = frameTimer.Tick();
+			CPU_PROFILE_SCOPE("Frame");
+
+			/* Swap in edited shaders and textures before anything uses them */
+			{
+				CPU_PROFILE_SCOPE("AssetWatcher::Update");
+				assetWatcher.Update();
+			}
+
 			GLCall(glClearColor(0.0f, 0.0f, 0.0f, 0.0f));
 			renderer.Clear();
 
+			int width, height;
+			glfwGetFramebufferSize(window, &width, &height);
+			Renderer::BeginFrame((float)glfwGetTime(), glm::vec2((float)width, (float)height));
+
+			StateCache::Get().ResetStats();
+			Renderer::ResetStats();
+			GpuProfiler::Get().BeginFrame();
+
 			ImGui_ImplGlfwGL3_NewFrame();
 			if (currentTest)
 			{
-				currentTest->OnUpdate(0.0f);
-				currentTest->OnRender();
+				{
+					CPU_PROFILE_SCOPE("OnUpdate");
+					currentTest->OnUpdate(deltaTime);
+				}
+				{
+					CPU_PROFILE_SCOPE("OnFixedUpdate");
+					for (int steps = fixedTimestep.Advance(deltaTime); steps > 0; steps--)
+						currentTest->OnFixedUpdate(fixedTimestep.GetStep());
+					currentTest->OnInterpolate(fixedTimestep.GetAlpha());
+				}
+				{
+					CPU_PROFILE_SCOPE("OnRender");
+					GPU_PROFILE_SCOPE("OnRender");
+					currentTest->OnRender();
+				}
+				CPU_PROFILE_SCOPE("OnImGuiRender");
 				ImGui::Begin("Test");
 				if (currentTest != testMenu && ImGui::Button("Back"))
 				{
@@ -87,22 +421,56 @@ int main(void)
 					currentTest = testMenu;
 				}
 				currentTest->OnImGuiRender();
+
+				/* Binds made through the StateCache while rendering this frame */
+				const StateCache::Stats& bindStats = StateCache::Get().GetStats();
+				ImGui::Separator();
+				ImGui::Text("Binds issued: %u, elided: %u", bindStats.Issued, bindStats.Elided);
+				const Renderer::Stats& drawStats = Renderer::GetStats();
+				ImGui::Text("Draw calls: %u, triangles: %u", drawStats.DrawCalls, drawStats.Triangles);
+				const AssetWatcher::Stats& reloadStats = assetWatcher.GetStats();
+				ImGui::Text("Hot reload (%s): %u reloaded, %u failed", assetWatcher.IsUsingInotify() ? "inotify" : "polling",
+					reloadStats.Reloaded, reloadStats.Failed);
+				if (CpuProfiler::IsCapturing())
+					ImGui::Text("Recording CPU trace...");
+				else
+					traceRequested = ImGui::Button("Capture CPU trace (F9)");
 				ImGui::End();
 			}
+			GpuProfiler::Get().OnImGuiRender();
+
+			ImGui::Begin("Frame Pacing");
+			if (frameTimer.OnImGuiRender())
+				glfwSwapInterval(frameTimer.GetPacing() == FramePacing::VSync ? 1 : 0);
+			fixedTimestep.OnImGuiRender();
+			ImGui::End();
 
 			ImGui::Render();
-			ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
+			{
+				CPU_PROFILE_SCOPE("ImGui_ImplGlfwGL3_RenderDrawData");
+				GPU_PROFILE_SCOPE("ImGui");
+				ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
+			}
+			GpuProfiler::Get().EndFrame();
 
 			/* Swap front and back buffers */
-			glfwSwapBuffers(window);
+			{
+				CPU_PROFILE_SCOPE("glfwSwapBuffers");
+				glfwSwapBuffers(window);
+			}
 
 			/* Poll for and process events */
-			glfwPollEvents();
+			{
+				CPU_PROFILE_SCOPE("glfwPollEvents");
+				glfwPollEvents();
+			}
 		}
 		delete currentTest;
 		if (currentTest != testMenu)
 			delete testMenu;
 
+		GpuProfiler::Get().Shutdown();
+		Renderer::Shutdown();
 		ImGui_ImplGlfwGL3_Shutdown();
 		ImGui::DestroyContext();
 		glfwTerminate();
@@ -0,0 +1,168 @@
+#include "AssetPack.h"
+
+#include "Hash.h"
+
+#include "stb_image/stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+static const char s_Magic[4] = { 'A', 'P', 'A', 'K' };
+static const uint32_t s_Version = 1;
+
+AssetPack::AssetPack(const std::string& path)
+	: m_File(path), m_Entries(nullptr), m_EntryCount(0)
+{
+	const size_t headerSize = sizeof(s_Magic) + 3 * sizeof(uint32_t);
+	if (!m_File.IsOpen() || m_File.GetSize() < headerSize)
+		return;
+
+	const unsigned char* data = m_File.GetData();
+	uint32_t header[3];
+	memcpy(header, data + sizeof(s_Magic), sizeof(header));
+	if (memcmp(data, s_Magic, sizeof(s_Magic)) != 0 || header[0] != s_Version)
+		return;
+
+	/* Reject truncated files up front so lookups never have to bounds check */
+	const AssetPackEntry* entries = (const AssetPackEntry*)(data + headerSize);
+	uint64_t size = m_File.GetSize();
+	if (headerSize + (uint64_t)header[1] * sizeof(AssetPackEntry) > size)
+		return;
+	for (uint32_t i = 0; i < header[1]; i++)
+	{
+		/* Written so neither side can wrap around */
+		const AssetPackEntry& entry = entries[i];
+		if (entry.Offset > size || entry.Size > size - entry.Offset)
+			return;
+		/* Textures are handed to Texture as width x height RGBA8 pixels */
+		if (entry.Type == AssetType::Texture && entry.Size != (uint64_t)entry.Width * entry.Height * 4)
+			return;
+	}
+
+	m_Entries = entries;
+	m_EntryCount = header[1];
+}
+
+const AssetPackEntry* AssetPack::Find(std::string_view name) const
+{
+	uint64_t hash = HashBytes(name.data(), name.size());
+	const AssetPackEntry* end = m_Entries + m_EntryCount;
+	const AssetPackEntry* entry = std::lower_bound(m_Entries, end, hash,
+		[](const AssetPackEntry& e, uint64_t h) { return e.NameHash < h; });
+	return entry != end && entry->NameHash == hash ? entry : nullptr;
+}
+
+ShaderIncludeResolver AssetPack::GetIncludeResolver() const
+{
+	return [this](const std::string& path, std::string& contents)
+	{
+		const AssetPackEntry* entry = Find(path);
+		if (!entry || entry->Type != AssetType::Shader)
+			return false;
+		contents.assign(GetText(*entry));
+		return true;
+	};
+}
+
+static bool ReadFile(const std::filesystem::path& path, std::vector<unsigned char>& data)
+{
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+		return false;
+	data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	return true;
+}
+
+int AssetPack::Build(const std::string& directory, const std::string& outputPath)
+{
+	struct Asset
+	{
+		AssetPackEntry Entry;
+		std::vector<unsigned char> Data;
+	};
+	std::vector<Asset> assets;
+
+	std::error_code error;
+	std::filesystem::path root(directory);
+	for (const auto& file : std::filesystem::recursive_directory_iterator(root, error))
+	{
+		if (!file.is_regular_file())
+			continue;
+
+		/* Keep the name relative to the working directory, the same string the loose loaders take */
+		std::string name = (root / file.path().lexically_relative(root)).generic_string();
+		std::string extension = file.path().extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)::tolower(c); });
+
+		Asset asset = {};
+		asset.Entry.NameHash = HashBytes(name.data(), name.size());
+		if (extension == ".shader" || extension == ".glsl")
+		{
+			asset.Entry.Type = AssetType::Shader;
+			if (!ReadFile(file.path(), asset.Data))
+				return -1;
+		}
+		else if (extension == ".png" || extension == ".jpg" || extension == ".tga" || extension == ".bmp")
+		{
+			/* Decode once here, with the same flip and channel count as Texture */
+			int width, height, bpp;
+			stbi_set_flip_vertically_on_load(1);
+			unsigned char* pixels = stbi_load(file.path().string().c_str(), &width, &height, &bpp, 4);
+			if (!pixels)
+				return -1;
+
+			asset.Entry.Type = AssetType::Texture;
+			asset.Entry.Width = (uint32_t)width;
+			asset.Entry.Height = (uint32_t)height;
+			asset.Data.assign(pixels, pixels + (size_t)width * height * 4);
+			stbi_image_free(pixels);
+		}
+		else
+			continue;
+
+		asset.Entry.Size = asset.Data.size();
+		assets.push_back(std::move(asset));
+	}
+	if (error)
+		return -1;
+
+	std::sort(assets.begin(), assets.end(),
+		[](const Asset& a, const Asset& b) { return a.Entry.NameHash < b.Entry.NameHash; });
+	for (size_t i = 1; i < assets.size(); i++)
+	{
+		if (assets[i].Entry.NameHash == assets[i - 1].Entry.NameHash)
+			return -1;
+	}
+
+	/* Lay the blobs out after the index */
+	const uint32_t alignMask = Alignment - 1;
+	uint64_t offset = sizeof(s_Magic) + 3 * sizeof(uint32_t) + assets.size() * sizeof(AssetPackEntry);
+	for (auto& asset : assets)
+	{
+		offset = (offset + alignMask) & ~(uint64_t)alignMask;
+		asset.Entry.Offset = offset;
+		offset += asset.Entry.Size;
+	}
+
+	std::ofstream stream(outputPath, std::ios::binary);
+	if (!stream)
+		return -1;
+
+	uint32_t header[3] = { s_Version, (uint32_t)assets.size(), 0 };
+	stream.write(s_Magic, sizeof(s_Magic));
+	stream.write((const char*)header, sizeof(header));
+	for (const auto& asset : assets)
+		stream.write((const char*)&asset.Entry, sizeof(asset.Entry));
+
+	static const char padding[Alignment] = {};
+	for (const auto& asset : assets)
+	{
+		stream.write(padding, (std::streamsize)(asset.Entry.Offset - (uint64_t)stream.tellp()));
+		stream.write((const char*)asset.Data.data(), (std::streamsize)asset.Data.size());
+	}
+	return stream ? (int)assets.size() : -1;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "ShaderPreprocessor.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+enum class AssetType : uint32_t
+{
+	Raw = 0,
+	Shader = 1,		// .shader and .glsl text as is
+	Texture = 2,	// RGBA8 pixels decoded by stb_image, bottom row first
+};
+
+/* One row of the index, which is sorted by NameHash */
+struct AssetPackEntry
+{
+	uint64_t NameHash;		// HashBytes of the path, e.g. "res/shaders/Basic.shader"
+	uint64_t Offset;		// from the start of the file, a multiple of AssetPack::Alignment
+	uint64_t Size;
+	AssetType Type;
+	uint32_t Width, Height;	// textures only
+	uint32_t Reserved;
+};
+
+/* Read-only archive of everything under res/, mapped into memory so assets are used
+   straight from the page cache without reading or decoding. Layout:
+
+	char[4]		"APAK"
+	uint32		version (1)
+	uint32		entry count
+	uint32		reserved
+	entries		AssetPackEntry[entry count]
+	blobs		each starting on an Alignment boundary */
+class AssetPack
+{
+public:
+	static const uint32_t Alignment = 64;
+
+private:
+	MappedFile m_File;
+	const AssetPackEntry* m_Entries;
+	uint32_t m_EntryCount;
+
+public:
+	AssetPack(const std::string& path);
+
+	inline bool IsOpen() const { return m_Entries != nullptr; }
+	inline uint32_t GetEntryCount() const { return m_EntryCount; }
+
+	/* Binary search of the index, returns nullptr for unknown names */
+	const AssetPackEntry* Find(std::string_view name) const;
+
+	inline const unsigned char* GetData(const AssetPackEntry& entry) const { return m_File.GetData() + entry.Offset; }
+	inline std::string_view GetText(const AssetPackEntry& entry) const { return std::string_view((const char*)GetData(entry), (size_t)entry.Size); }
+
+	/* Looks #include paths up in the pack rather than on disk, for Shader's in-memory
+	   constructor. The pack has to outlive the call */
+	ShaderIncludeResolver GetIncludeResolver() const;
+
+	/* Pack every .shader, .glsl and image file under directory, names keep the directory
+	   prefix with forward slashes. Returns the number of assets written, or -1 */
+	static int Build(const std::string& directory, const std::string& outputPath);
+};
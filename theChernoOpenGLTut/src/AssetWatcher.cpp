@@ -0,0 +1,259 @@
+#include "AssetWatcher.h"
+
+#include "CpuProfiler.h"
+#include "Shader.h"
+#include "Texture.h"
+
+#include "stb_image/stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <unordered_map>
+
+#ifdef __linux__
+	#include <poll.h>
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+std::unordered_set<Shader*> AssetWatcher::s_Shaders;
+std::unordered_set<Texture*> AssetWatcher::s_Textures;
+
+static std::string Normalise(const std::string& path)
+{
+	return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+static bool HasExtension(const std::string& path, std::initializer_list<const char*> extensions)
+{
+	std::string extension = std::filesystem::path(path).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)::tolower(c); });
+	return std::find_if(extensions.begin(), extensions.end(),
+		[&](const char* e) { return extension == e; }) != extensions.end();
+}
+
+AssetWatcher::AssetWatcher(const std::string& directory)
+	: m_Directory(Normalise(directory)), m_Running(true), m_Inotify(false), m_Stats{ 0, 0 }
+{
+	int inotify = -1;
+#ifdef __linux__
+	inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+	m_Inotify = inotify != -1;
+	m_Thread = std::thread(&AssetWatcher::Run, this, inotify);
+}
+
+AssetWatcher::~AssetWatcher()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Running = false;
+	}
+	m_Wake.notify_all();
+	m_Thread.join();
+}
+
+void AssetWatcher::Update()
+{
+	std::vector<Change> changes;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		changes.swap(m_Changes);
+	}
+
+	for (Change& change : changes)
+	{
+		if (change.Width > 0)
+		{
+			for (Texture* texture : s_Textures)
+			{
+				if (texture->IsCompressed() || Normalise(texture->GetFilePath()) != change.Path)
+					continue;
+
+				texture->Replace(Texture::CreateStorage(change.Width, change.Height, change.Pixels.data(), texture->GetSpec()),
+					change.Width, change.Height);
+				m_Stats.Reloaded++;
+				std::cout << "Reloaded " << change.Path << std::endl;
+			}
+			continue;
+		}
+
+		/* Shaders created later must see the edit too, not just the ones alive now */
+		if (HasExtension(change.Path, { ".glsl" }))
+			ShaderPreprocessor::SetInclude(change.Path, change.Text);
+		else
+			ShaderPreprocessor::InvalidateInclude(change.Path);
+
+		for (Shader* shader : s_Shaders)
+		{
+			bool reloaded;
+			if (Normalise(shader->GetFilePath()) == change.Path)
+			{
+				reloaded = shader->Reload(change.Text);
+			}
+			else if (shader->DependsOn(change.Path))
+			{
+				/* An edited include, every shader pulling it in is rebuilt from its own file */
+				reloaded = shader->Reload();
+			}
+			else
+			{
+				continue;
+			}
+
+			if (reloaded)
+				m_Stats.Reloaded++;
+			else
+				m_Stats.Failed++;
+			std::cout << (reloaded ? "Reloaded " : "Failed to reload ") << shader->GetFilePath() << std::endl;
+		}
+	}
+}
+
+void AssetWatcher::Run(int inotify)
+{
+	CpuProfiler::SetThreadName("Asset watcher");
+	if (inotify != -1)
+		RunInotify(inotify);
+	else
+		RunPolling();
+}
+
+void AssetWatcher::RunInotify(int inotify)
+{
+#ifdef __linux__
+	/* inotify isn't recursive, so every directory gets its own watch */
+	std::unordered_map<int, std::string> directories;
+	auto addWatch = [&](const std::string& directory)
+	{
+		int watch = inotify_add_watch(inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		if (watch != -1)
+			directories[watch] = directory;
+	};
+
+	addWatch(m_Directory);
+	std::error_code error;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(m_Directory, error))
+	{
+		if (entry.is_directory())
+			addWatch(Normalise(entry.path().generic_string()));
+	}
+
+	alignas(inotify_event) char buffer[4096];
+	while (m_Running)
+	{
+		/* Wake up now and then to notice the destructor */
+		pollfd descriptor = { inotify, POLLIN, 0 };
+		if (poll(&descriptor, 1, 100) <= 0)
+			continue;
+
+		ssize_t length;
+		while ((length = read(inotify, buffer, sizeof(buffer))) > 0)
+		{
+			for (char* next = buffer; next < buffer + length;)
+			{
+				const inotify_event* event = (const inotify_event*)next;
+				next += sizeof(inotify_event) + event->len;
+
+				auto directory = directories.find(event->wd);
+				if (event->len == 0 || directory == directories.end())
+					continue;
+
+				std::string path = directory->second + "/" + event->name;
+				if (event->mask & IN_ISDIR)
+				{
+					if (event->mask & (IN_CREATE | IN_MOVED_TO))
+						addWatch(path);
+				}
+				/* Editors either rewrite the file in place or rename a new one over it */
+				else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+				{
+					OnFileChanged(path);
+				}
+			}
+		}
+	}
+	close(inotify);
+#endif
+}
+
+void AssetWatcher::RunPolling()
+{
+	std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes;
+	bool initialScan = true;
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (m_Running)
+	{
+		lock.unlock();
+		std::error_code error;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(m_Directory, error))
+		{
+			if (!entry.is_regular_file())
+				continue;
+
+			std::filesystem::file_time_type writeTime = entry.last_write_time(error);
+			if (error)
+				continue;
+
+			std::string path = Normalise(entry.path().generic_string());
+			auto it = writeTimes.find(path);
+			bool changed = it == writeTimes.end() ? !initialScan : it->second != writeTime;
+			writeTimes[path] = writeTime;
+			if (changed)
+				OnFileChanged(path);
+		}
+		initialScan = false;
+
+		lock.lock();
+		m_Wake.wait_for(lock, std::chrono::milliseconds(250), [this] { return !m_Running; });
+	}
+}
+
+void AssetWatcher::OnFileChanged(const std::string& path)
+{
+	CPU_PROFILE_SCOPE("AssetWatcher::OnFileChanged");
+	Change change;
+	change.Path = Normalise(path);
+	change.Width = change.Height = 0;
+
+	if (HasExtension(path, { ".png", ".jpg", ".tga", ".bmp" }))
+	{
+		/* Same flip and channel count as Texture */
+		int bpp;
+		stbi_set_flip_vertically_on_load(1);
+		unsigned char* pixels = stbi_load(path.c_str(), &change.Width, &change.Height, &bpp, 4);
+		if (!pixels)
+		{
+			std::cout << "Warning: could not reload texture '" << path << "'" << std::endl;
+			return;
+		}
+		change.Pixels.assign(pixels, pixels + (size_t)change.Width * change.Height * 4);
+		stbi_image_free(pixels);
+	}
+	else if (HasExtension(path, { ".shader", ".glsl" }))
+	{
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream)
+			return;
+		change.Text.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+	else
+	{
+		return;
+	}
+
+	/* Several events for one save only need the last version */
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto previous = std::find_if(m_Changes.begin(), m_Changes.end(),
+		[&](const Change& queued) { return queued.Path == change.Path; });
+	if (previous != m_Changes.end())
+		*previous = std::move(change);
+	else
+		m_Changes.push_back(std::move(change));
+}
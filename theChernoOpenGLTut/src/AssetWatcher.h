@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+class Shader;
+class Texture;
+
+/* Hot reload of everything under a directory. A background thread notices edits
+   (inotify on Linux, polling last write times elsewhere), reads the new shader text or
+   decodes the new image, and Update swaps the results in at the start of a frame.
+   Shaders and textures register themselves, so anything loaded from a path is covered */
+class AssetWatcher
+{
+public:
+	struct Stats
+	{
+		unsigned int Reloaded;
+		unsigned int Failed;	// compile or link errors, the previous program is kept
+	};
+
+private:
+	/* What the watcher thread has prepared for one edited file */
+	struct Change
+	{
+		std::string Path;
+		std::string Text;					// shaders and includes
+		std::vector<unsigned char> Pixels;	// images, RGBA8 bottom row first
+		int Width, Height;
+	};
+
+	static std::unordered_set<Shader*> s_Shaders;
+	static std::unordered_set<Texture*> s_Textures;
+
+	std::string m_Directory;
+	std::thread m_Thread;
+	std::atomic<bool> m_Running;
+	bool m_Inotify;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_Wake;
+	std::vector<Change> m_Changes;
+
+	Stats m_Stats;
+
+public:
+	AssetWatcher(const std::string& directory);
+	~AssetWatcher();
+
+	/* Call on the render thread before anything is drawn for the frame */
+	void Update();
+
+	inline bool IsUsingInotify() const { return m_Inotify; }
+	inline const Stats& GetStats() const { return m_Stats; }
+
+	static void OnShaderCreated(Shader* shader) { s_Shaders.insert(shader); }
+	static void OnShaderDeleted(Shader* shader) { s_Shaders.erase(shader); }
+	static void OnTextureCreated(Texture* texture) { s_Textures.insert(texture); }
+	static void OnTextureDeleted(Texture* texture) { s_Textures.erase(texture); }
+
+private:
+	void Run(int inotify);
+	void RunInotify(int inotify);
+	void RunPolling();
+	/* Watcher thread, load path and queue it for Update */
+	void OnFileChanged(const std::string& path);
+};
@@ -0,0 +1,174 @@
+#include "BatchRenderer.h"
+
+#include "VertexBufferLayout.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+
+/* Corners of the unit quad, in the same winding as the test quads */
+static const glm::vec4 s_QuadPositions[4] =
+{
+	{ -0.5f, -0.5f, 0.0f, 1.0f },
+	{  0.5f, -0.5f, 0.0f, 1.0f },
+	{  0.5f,  0.5f, 0.0f, 1.0f },
+	{ -0.5f,  0.5f, 0.0f, 1.0f },
+};
+
+static const glm::vec2 s_QuadTexCoords[4] =
+{
+	{ 0.0f, 0.0f },
+	{ 1.0f, 0.0f },
+	{ 1.0f, 1.0f },
+	{ 0.0f, 1.0f },
+};
+
+BatchRenderer::BatchRenderer(unsigned int maxQuads)
+	: m_MaxQuads(maxQuads), m_TextureSlots{}, m_TextureSlotCount(0), m_MaxTextureSlots(0),
+	m_Stats{ 0, 0 }
+{
+	m_Vertices.reserve(m_MaxQuads * 4);
+
+	/* Use as many slots as the fragment stage can sample from */
+	int textureUnits;
+	GLCall(glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &textureUnits));
+	m_MaxTextureSlots = std::min((unsigned int)textureUnits, MaxTextureSlots);
+
+	/* Every quad uses the same index pattern, so the index buffer is built once */
+	std::vector<unsigned int> indices(m_MaxQuads * 6);
+	for (unsigned int i = 0; i < m_MaxQuads; i++)
+	{
+		unsigned int offset = i * 4;
+		indices[i * 6 + 0] = offset + 0;
+		indices[i * 6 + 1] = offset + 1;
+		indices[i * 6 + 2] = offset + 2;
+		indices[i * 6 + 3] = offset + 2;
+		indices[i * 6 + 4] = offset + 3;
+		indices[i * 6 + 5] = offset + 0;
+	}
+
+	m_VAO = std::make_unique<VertexArray>();
+	m_VBO = std::make_unique<StreamingVertexBuffer>((unsigned int)sizeof(QuadVertex), m_MaxQuads * 4);
+
+	VertexBufferLayout layout;
+	layout.Push<float>(3);
+	layout.Push<float>(4);
+	layout.Push<float>(2);
+	layout.Push<float>(1);
+	m_VAO->AddBuffer(*m_VBO, layout);
+
+	m_IBO = std::make_unique<IndexBuffer>(indices.data(), m_MaxQuads * 6);
+
+	ShaderDefines defines;
+	defines["MAX_TEXTURE_SLOTS"] = std::to_string(m_MaxTextureSlots);
+	m_Shader = std::make_unique<Shader>("res/shaders/Batch.shader", defines);
+
+	int samplers[MaxTextureSlots];
+	for (unsigned int i = 0; i < m_MaxTextureSlots; i++)
+		samplers[i] = i;
+	m_Shader->Bind();
+	m_Shader->SetUniform1iv("u_Textures", m_MaxTextureSlots, samplers);
+}
+
+BatchRenderer::~BatchRenderer()
+{
+}
+
+void BatchRenderer::Begin()
+{
+	m_Vertices.clear();
+	m_TextureSlotCount = 0;
+	m_VBO->BeginRegion();
+}
+
+void BatchRenderer::End()
+{
+	Flush();
+	m_VBO->EndRegion();
+}
+
+void BatchRenderer::DrawQuad(const glm::mat4& transform, const Texture& texture, const glm::vec4& colour)
+{
+	if (m_Vertices.size() >= m_MaxQuads * 4)
+		Flush();
+
+	PushQuad(transform, GetTextureSlot(texture), glm::vec2(0.0f), glm::vec2(1.0f), colour);
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size, const Texture& texture, const glm::vec4& colour)
+{
+	glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(position, 0.0f))
+		* glm::scale(glm::mat4(1.0f), glm::vec3(size, 1.0f));
+	DrawQuad(transform, texture, colour);
+}
+
+void BatchRenderer::DrawQuad(const glm::mat4& transform, const SubTexture& subTexture, const glm::vec4& colour)
+{
+	if (m_Vertices.size() >= m_MaxQuads * 4)
+		Flush();
+
+	PushQuad(transform, GetTextureSlot(*subTexture.Page), subTexture.UVMin, subTexture.UVMax, colour);
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size, const SubTexture& subTexture, const glm::vec4& colour)
+{
+	glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(position, 0.0f))
+		* glm::scale(glm::mat4(1.0f), glm::vec3(size, 1.0f));
+	DrawQuad(transform, subTexture, colour);
+}
+
+void BatchRenderer::PushQuad(const glm::mat4& transform, float texIndex, const glm::vec2& uvMin, const glm::vec2& uvMax, const glm::vec4& colour)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		QuadVertex vertex;
+		vertex.Position = glm::vec3(transform * s_QuadPositions[i]);
+		vertex.Colour = colour;
+		vertex.TexCoord = uvMin + (uvMax - uvMin) * s_QuadTexCoords[i];
+		vertex.TexIndex = texIndex;
+		m_Vertices.push_back(vertex);
+	}
+	m_Stats.QuadCount++;
+}
+
+void BatchRenderer::ResetStats()
+{
+	m_Stats = { 0, 0 };
+}
+
+/* Reuse the slot of a texture already in the batch, otherwise claim the next free one */
+float BatchRenderer::GetTextureSlot(const Texture& texture)
+{
+	for (unsigned int i = 0; i < m_TextureSlotCount; i++)
+	{
+		if (m_TextureSlots[i]->GetRendererID() == texture.GetRendererID())
+			return (float)i;
+	}
+
+	/* Out of slots, the batch has to be drawn before another texture can be bound */
+	if (m_TextureSlotCount == m_MaxTextureSlots)
+	{
+		Flush();
+		m_TextureSlotCount = 0;
+	}
+
+	m_TextureSlots[m_TextureSlotCount] = &texture;
+	return (float)m_TextureSlotCount++;
+}
+
+void BatchRenderer::Flush()
+{
+	if (m_Vertices.empty())
+		return;
+
+	unsigned int quadCount = (unsigned int)m_Vertices.size() / 4;
+	unsigned int baseVertex = m_VBO->Write(m_Vertices.data(), (unsigned int)m_Vertices.size());
+
+	for (unsigned int i = 0; i < m_TextureSlotCount; i++)
+		m_TextureSlots[i]->Bind(i);
+	m_Shader->Bind();
+	m_Renderer.Draw(*m_VAO, *m_IBO, *m_Shader, quadCount * 6, baseVertex);
+
+	m_Vertices.clear();
+	m_Stats.DrawCalls++;
+}
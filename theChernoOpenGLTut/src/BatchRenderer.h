@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Renderer.h"
+#include "StreamingVertexBuffer.h"
+#include "Texture.h"
+#include "TextureAtlas.h"
+
+#include "glm/glm.hpp"
+
+struct QuadVertex
+{
+	glm::vec3 Position;
+	glm::vec4 Colour;
+	glm::vec2 TexCoord;
+	float TexIndex;
+};
+
+/* Collects quads on the CPU and draws them with one glDrawElements per flush */
+class BatchRenderer
+{
+public:
+	/* Upper bound on texture slots, matches the cases in Batch.shader */
+	static constexpr unsigned int MaxTextureSlots = 32;
+
+	struct Stats
+	{
+		unsigned int DrawCalls;
+		unsigned int QuadCount;
+	};
+
+private:
+	unsigned int m_MaxQuads;
+
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<StreamingVertexBuffer> m_VBO;
+	std::unique_ptr<IndexBuffer> m_IBO;
+	std::unique_ptr<Shader> m_Shader;
+
+	std::vector<QuadVertex> m_Vertices;
+
+	/* Textures referenced by the current batch, indexed by slot */
+	const Texture* m_TextureSlots[MaxTextureSlots];
+	unsigned int m_TextureSlotCount;
+	unsigned int m_MaxTextureSlots;
+
+	Renderer m_Renderer;
+	Stats m_Stats;
+
+public:
+	BatchRenderer(unsigned int maxQuads = 10000);
+	~BatchRenderer();
+
+	/* Quads are transformed by the Camera block, see Renderer::SetCamera */
+	void Begin();
+	void End();
+
+	/* transform maps the unit quad (-0.5 to 0.5) into world space */
+	void DrawQuad(const glm::mat4& transform, const Texture& texture, const glm::vec4& colour = glm::vec4(1.0f));
+	void DrawQuad(const glm::vec2& position, const glm::vec2& size, const Texture& texture, const glm::vec4& colour = glm::vec4(1.0f));
+
+	/* Atlas images share their page's texture slot, so they never break the batch */
+	void DrawQuad(const glm::mat4& transform, const SubTexture& subTexture, const glm::vec4& colour = glm::vec4(1.0f));
+	void DrawQuad(const glm::vec2& position, const glm::vec2& size, const SubTexture& subTexture, const glm::vec4& colour = glm::vec4(1.0f));
+
+	inline const Stats& GetStats() const { return m_Stats; }
+	inline unsigned int GetMaxTextureSlots() const { return m_MaxTextureSlots; }
+	inline bool IsPersistentMapped() const { return m_VBO->IsPersistent(); }
+	void ResetStats();
+
+private:
+	float GetTextureSlot(const Texture& texture);
+	void PushQuad(const glm::mat4& transform, float texIndex, const glm::vec2& uvMin, const glm::vec2& uvMax, const glm::vec4& colour);
+	void Flush();
+};
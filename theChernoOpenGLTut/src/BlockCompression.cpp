@@ -0,0 +1,187 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+static unsigned short PackRGB565(const int* rgb)
+{
+	return (unsigned short)(((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3));
+}
+
+static void UnpackRGB565(unsigned short colour, int* rgb)
+{
+	/* Replicate the top bits so 0x1F expands to 0xFF */
+	int r = (colour >> 11) & 0x1F, g = (colour >> 5) & 0x3F, b = colour & 0x1F;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+/* Bounding box fit: the endpoints are the per-channel extremes, pulled in by 1/16 of
+   the range so the interpolated colours land closer to the block's actual pixels */
+void CompressBlockBC1(const unsigned char* rgba, unsigned char* out)
+{
+	int minColour[3] = { 255, 255, 255 }, maxColour[3] = { 0, 0, 0 };
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			minColour[c] = std::min(minColour[c], (int)rgba[i * 4 + c]);
+			maxColour[c] = std::max(maxColour[c], (int)rgba[i * 4 + c]);
+		}
+	}
+	for (int c = 0; c < 3; c++)
+	{
+		int inset = (maxColour[c] - minColour[c]) >> 4;
+		minColour[c] += inset;
+		maxColour[c] -= inset;
+	}
+
+	unsigned short colour0 = PackRGB565(maxColour);
+	unsigned short colour1 = PackRGB565(minColour);
+	if (colour0 < colour1)
+		std::swap(colour0, colour1);
+
+	unsigned int indices = 0;
+
+	/* colour0 > colour1 selects the four colour mode, equal endpoints leave every index at 0 */
+	if (colour0 != colour1)
+	{
+		int palette[4][3];
+		UnpackRGB565(colour0, palette[0]);
+		UnpackRGB565(colour1, palette[1]);
+		for (int c = 0; c < 3; c++)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			int best = 0, bestDistance = 0x7FFFFFFF;
+			for (int p = 0; p < 4; p++)
+			{
+				int distance = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					int d = rgba[i * 4 + c] - palette[p][c];
+					distance += d * d;
+				}
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					best = p;
+				}
+			}
+			indices |= best << (i * 2);
+		}
+	}
+
+	out[0] = colour0 & 0xFF;
+	out[1] = colour0 >> 8;
+	out[2] = colour1 & 0xFF;
+	out[3] = colour1 >> 8;
+	for (int i = 0; i < 4; i++)
+		out[4 + i] = (indices >> (i * 8)) & 0xFF;
+}
+
+void CompressBlockBC3(const unsigned char* rgba, unsigned char* out)
+{
+	int alpha0 = 0, alpha1 = 255;
+	for (int i = 0; i < 16; i++)
+	{
+		alpha0 = std::max(alpha0, (int)rgba[i * 4 + 3]);
+		alpha1 = std::min(alpha1, (int)rgba[i * 4 + 3]);
+	}
+
+	/* alpha0 > alpha1 selects eight interpolated values, equal endpoints leave every index at 0 */
+	unsigned long long indices = 0;
+	if (alpha0 != alpha1)
+	{
+		int palette[8] = { alpha0, alpha1 };
+		for (int p = 2; p < 8; p++)
+			palette[p] = ((8 - p) * alpha0 + (p - 1) * alpha1) / 7;
+
+		for (int i = 0; i < 16; i++)
+		{
+			int best = 0, bestDistance = 256;
+			for (int p = 0; p < 8; p++)
+			{
+				int distance = std::abs(rgba[i * 4 + 3] - palette[p]);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					best = p;
+				}
+			}
+			indices |= (unsigned long long)best << (i * 3);
+		}
+	}
+
+	out[0] = (unsigned char)alpha0;
+	out[1] = (unsigned char)alpha1;
+	for (int i = 0; i < 6; i++)
+		out[2 + i] = (indices >> (i * 8)) & 0xFF;
+
+	CompressBlockBC1(rgba, out + 8);
+}
+
+static void CompressBlockRows(const unsigned char* pixels, int width, int height, BlockFormat format,
+	int firstRow, int lastRow, unsigned char* out)
+{
+	int blocksX = (width + 3) / 4;
+	unsigned int blockSize = GetBlockSize(format);
+	unsigned char block[64];
+
+	for (int by = firstRow; by < lastRow; by++)
+	{
+		for (int bx = 0; bx < blocksX; bx++)
+		{
+			/* Levels smaller than a block repeat their edge pixels */
+			for (int y = 0; y < 4; y++)
+			{
+				int sy = std::min(by * 4 + y, height - 1);
+				for (int x = 0; x < 4; x++)
+				{
+					int sx = std::min(bx * 4 + x, width - 1);
+					const unsigned char* src = pixels + ((size_t)sy * width + sx) * 4;
+					std::copy(src, src + 4, block + (y * 4 + x) * 4);
+				}
+			}
+
+			unsigned char* dst = out + ((size_t)by * blocksX + bx) * blockSize;
+			if (format == BlockFormat::BC1)
+				CompressBlockBC1(block, dst);
+			else
+				CompressBlockBC3(block, dst);
+		}
+	}
+}
+
+std::vector<unsigned char> CompressImage(const unsigned char* pixels, int width, int height,
+	BlockFormat format, unsigned int threadCount)
+{
+	std::vector<unsigned char> result(GetCompressedSize(format, width, height));
+
+	int blocksY = (height + 3) / 4;
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	threadCount = std::min(threadCount, (unsigned int)blocksY);
+
+	/* Block rows are independent, so each thread takes a contiguous range of them */
+	std::vector<std::thread> threads;
+	int rowsPerThread = (blocksY + threadCount - 1) / threadCount;
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		int firstRow = i * rowsPerThread;
+		int lastRow = std::min(blocksY, firstRow + rowsPerThread);
+		if (firstRow >= lastRow)
+			break;
+		threads.emplace_back(CompressBlockRows, pixels, width, height, format, firstRow, lastRow, result.data());
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+
+	return result;
+}
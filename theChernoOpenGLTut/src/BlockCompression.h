@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/* S3TC block formats, values are stored as-is in .ctex files */
+enum class BlockFormat : unsigned int
+{
+	BC1 = 1,	// DXT1, RGB 5:6:5 endpoints, 8 bytes per 4x4 block, no alpha
+	BC3 = 3,	// DXT5, BC1 colour plus an interpolated alpha block, 16 bytes per 4x4 block
+};
+
+inline unsigned int GetBlockSize(BlockFormat format) { return format == BlockFormat::BC1 ? 8 : 16; }
+
+/* Bytes taken by a width x height level, partial blocks at the edges count as whole ones */
+inline size_t GetCompressedSize(BlockFormat format, int width, int height)
+{
+	return (size_t)((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+}
+
+/* Encode one block, rgba holds the 4x4 pixels row by row */
+void CompressBlockBC1(const unsigned char* rgba, unsigned char* out);
+void CompressBlockBC3(const unsigned char* rgba, unsigned char* out);
+
+/* Encode a whole RGBA8 image, splitting the block rows over threadCount threads (0 for all cores) */
+std::vector<unsigned char> CompressImage(const unsigned char* pixels, int width, int height,
+	BlockFormat format, unsigned int threadCount = 0);
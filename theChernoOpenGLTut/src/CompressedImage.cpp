@@ -0,0 +1,100 @@
+#include "CompressedImage.h"
+
+#include "MipChain.h"
+
+#include "stb_image/stb_image.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+static const char s_Magic[4] = { 'C', 'T', 'E', 'X' };
+static const uint32_t s_Version = 1;
+
+/* What desktop drivers commonly allow, anything larger is a corrupt header asking for gigabytes */
+static const uint32_t s_MaxDimension = 16384;
+
+bool ReadCompressedImage(const std::string& path, CompressedImage& image)
+{
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+		return false;
+
+	char magic[4];
+	uint32_t header[5];
+	stream.read(magic, sizeof(magic));
+	stream.read((char*)header, sizeof(header));
+	if (!stream || memcmp(magic, s_Magic, sizeof(magic)) != 0 || header[0] != s_Version)
+		return false;
+
+	image.Format = (BlockFormat)header[1];
+	if (image.Format != BlockFormat::BC1 && image.Format != BlockFormat::BC3)
+		return false;
+	if (header[2] == 0 || header[3] == 0 || header[2] > s_MaxDimension || header[3] > s_MaxDimension)
+		return false;
+	image.Width = (int)header[2];
+	image.Height = (int)header[3];
+	if (header[4] == 0 || header[4] > GetMipLevelCount(image.Width, image.Height))
+		return false;
+
+	/* Every level has to be exactly the blocks its mip size needs, Texture uploads them as is */
+	image.Levels.resize(header[4]);
+	for (size_t i = 0; i < image.Levels.size(); i++)
+	{
+		int width = std::max(1, image.Width >> i), height = std::max(1, image.Height >> i);
+		uint32_t size = 0;
+		stream.read((char*)&size, sizeof(size));
+		if (!stream || size != GetCompressedSize(image.Format, width, height))
+			return false;
+
+		image.Levels[i].resize(size);
+		stream.read((char*)image.Levels[i].data(), size);
+		if (!stream)
+			return false;
+	}
+	return true;
+}
+
+bool WriteCompressedImage(const std::string& path, const CompressedImage& image)
+{
+	std::ofstream stream(path, std::ios::binary);
+	if (!stream)
+		return false;
+
+	uint32_t header[5] = { s_Version, (uint32_t)image.Format, (uint32_t)image.Width, (uint32_t)image.Height, (uint32_t)image.Levels.size() };
+	stream.write(s_Magic, sizeof(s_Magic));
+	stream.write((const char*)header, sizeof(header));
+	for (const auto& level : image.Levels)
+	{
+		uint32_t size = (uint32_t)level.size();
+		stream.write((const char*)&size, sizeof(size));
+		stream.write((const char*)level.data(), size);
+	}
+	return (bool)stream;
+}
+
+bool CookCompressedImage(const std::string& inputPath, BlockFormat format, unsigned int threadCount,
+	bool mips, CompressedImage& image)
+{
+	/* Same orientation as Texture, so cooked and uncooked files look alike */
+	stbi_set_flip_vertically_on_load(1);
+
+	int width, height, bpp;
+	unsigned char* pixels = stbi_load(inputPath.c_str(), &width, &height, &bpp, 4);
+	if (!pixels)
+		return false;
+
+	std::vector<unsigned char> mipStorage;
+	std::vector<MipLevel> levels = BuildMipChain(pixels, width, height, mips ? GetMipLevelCount(width, height) : 1, mipStorage);
+
+	image.Format = format;
+	image.Width = width;
+	image.Height = height;
+	image.Levels.clear();
+	for (const MipLevel& level : levels)
+		image.Levels.push_back(CompressImage(level.Pixels, level.Width, level.Height, format, threadCount));
+
+	stbi_image_free(pixels);
+	return true;
+}
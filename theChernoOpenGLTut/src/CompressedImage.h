@@ -0,0 +1,30 @@
+#pragma once
+
+#include "BlockCompression.h"
+
+#include <string>
+#include <vector>
+
+/* Block compressed image with its prebuilt mip chain, as stored in a .ctex file:
+
+	char[4]		"CTEX"
+	uint32		version (1)
+	uint32		BlockFormat
+	uint32		width, height of level 0
+	uint32		level count
+	per level:	uint32 byte size, then the blocks */
+struct CompressedImage
+{
+	BlockFormat Format;
+	int Width, Height;
+	std::vector<std::vector<unsigned char>> Levels;
+};
+
+/* False for anything that isn't a complete BC1/BC3 file whose level count and level sizes
+   match its dimensions */
+bool ReadCompressedImage(const std::string& path, CompressedImage& image);
+bool WriteCompressedImage(const std::string& path, const CompressedImage& image);
+
+/* Decode an image file with stb_image, build the full mip chain and compress every level */
+bool CookCompressedImage(const std::string& inputPath, BlockFormat format, unsigned int threadCount,
+	bool mips, CompressedImage& image);
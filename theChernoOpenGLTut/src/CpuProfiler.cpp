@@ -0,0 +1,167 @@
+#include "CpuProfiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+std::atomic<bool> CpuProfiler::s_Enabled(false);
+std::atomic<unsigned int> CpuProfiler::s_Generation(0);
+std::mutex CpuProfiler::s_BuffersMutex;
+std::vector<std::unique_ptr<CpuProfiler::ThreadBuffer>> CpuProfiler::s_Buffers;
+thread_local CpuProfiler::ThreadBuffer* CpuProfiler::s_ThreadBuffer = nullptr;
+int CpuProfiler::s_CaptureFramesLeft = 0;
+std::string CpuProfiler::s_CapturePath;
+
+static const std::chrono::steady_clock::time_point s_Epoch = std::chrono::steady_clock::now();
+
+int64_t CpuProfiler::Now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_Epoch).count();
+}
+
+CpuProfiler::ThreadBuffer& CpuProfiler::GetThreadBuffer()
+{
+	if (!s_ThreadBuffer)
+	{
+		std::lock_guard<std::mutex> lock(s_BuffersMutex);
+		std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+		buffer->Count = 0;
+		buffer->Dropped = 0;
+		buffer->Generation = s_Generation.load(std::memory_order_relaxed);
+		buffer->ThreadID = (unsigned int)s_Buffers.size() + 1;
+		s_ThreadBuffer = buffer.get();
+		s_Buffers.push_back(std::move(buffer));
+	}
+	return *s_ThreadBuffer;
+}
+
+void CpuProfiler::Record(const char* name, int64_t begin, int64_t end)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+	/* Threads that are only named don't pay for the storage */
+	if (!buffer.Events)
+		buffer.Events = std::make_unique<Event[]>(ThreadBuffer::Capacity);
+
+	/* First event since Start, only this thread writes Count so only it may reset it.
+	   Acquiring the generation orders the overwrites after whatever read the old events
+	   before Start, and it's stored last so a reader that sees it also sees the reset */
+	unsigned int generation = s_Generation.load(std::memory_order_acquire);
+	if (buffer.Generation.load(std::memory_order_relaxed) != generation)
+	{
+		buffer.Count.store(0, std::memory_order_relaxed);
+		buffer.Dropped.store(0, std::memory_order_relaxed);
+		buffer.Generation.store(generation, std::memory_order_release);
+	}
+
+	size_t index = buffer.Count.load(std::memory_order_relaxed);
+	if (index == ThreadBuffer::Capacity)
+	{
+		buffer.Dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	buffer.Events[index] = { name, begin, end };
+	/* Publish the event before the count that makes it visible */
+	buffer.Count.store(index + 1, std::memory_order_release);
+}
+
+void CpuProfiler::SetThreadName(const std::string& name)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(s_BuffersMutex);
+	buffer.Name = name;
+}
+
+void CpuProfiler::Start()
+{
+	s_Generation.fetch_add(1, std::memory_order_release);
+	s_Enabled.store(true, std::memory_order_relaxed);
+}
+
+void CpuProfiler::Stop()
+{
+	s_Enabled.store(false, std::memory_order_relaxed);
+}
+
+void CpuProfiler::CaptureFrames(int frameCount, const std::string& path)
+{
+	if (IsCapturing())
+		return;
+
+	s_CaptureFramesLeft = frameCount;
+	s_CapturePath = path;
+	Start();
+}
+
+void CpuProfiler::OnFrameEnd()
+{
+	if (!IsCapturing() || --s_CaptureFramesLeft > 0)
+		return;
+
+	Stop();
+	if (WriteChromeTrace(s_CapturePath))
+		std::cout << "Wrote CPU trace to " << s_CapturePath << ", open it in chrome://tracing or ui.perfetto.dev" << std::endl;
+	else
+		std::cout << "Warning: could not write CPU trace to " << s_CapturePath << std::endl;
+}
+
+static void WriteEscaped(FILE* file, const std::string& str)
+{
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+			fputc('\\', file);
+		if ((unsigned char)c >= 0x20)
+			fputc(c, file);
+	}
+}
+
+bool CpuProfiler::WriteChromeTrace(const std::string& path)
+{
+	FILE* file = fopen(path.c_str(), "w");
+	if (!file)
+		return false;
+
+	/* Complete ("X") events, timestamps and durations in microseconds */
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+	unsigned int dropped = 0;
+
+	unsigned int generation = s_Generation.load(std::memory_order_relaxed);
+	std::lock_guard<std::mutex> lock(s_BuffersMutex);
+	for (auto& buffer : s_Buffers)
+	{
+		/* Threads that haven't recorded since Start still hold the previous capture */
+		if (buffer->Generation.load(std::memory_order_acquire) != generation)
+			continue;
+
+		size_t count = buffer->Count.load(std::memory_order_acquire);
+		dropped += buffer->Dropped.load(std::memory_order_relaxed);
+		if (count == 0)
+			continue;
+
+		if (!buffer->Name.empty())
+		{
+			fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", first ? "" : ",\n", buffer->ThreadID);
+			WriteEscaped(file, buffer->Name);
+			fprintf(file, "\"}}");
+			first = false;
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const Event& event = buffer->Events[i];
+			fprintf(file, "%s{\"ph\":\"X\",\"name\":\"", first ? "" : ",\n");
+			WriteEscaped(file, event.Name);
+			fprintf(file, "\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer->ThreadID,
+				event.Begin / 1000.0, (event.End - event.Begin) / 1000.0);
+			first = false;
+		}
+	}
+	fprintf(file, "\n]}\n");
+	bool ok = ferror(file) == 0;
+	fclose(file);
+
+	if (dropped > 0)
+		std::cout << "Warning: " << dropped << " CPU profiler events didn't fit their thread's buffer" << std::endl;
+	return ok;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* Define CPU_PROFILING 0 to compile every CPU_PROFILE_SCOPE out */
+#ifndef CPU_PROFILING
+	#define CPU_PROFILING 1
+#endif
+
+/* Scoped CPU timings from every thread, written out as a chrome://tracing / Perfetto JSON.
+   Each thread appends to its own fixed size buffer, so recording takes no locks; when a
+   buffer fills up further events are counted and dropped. While not recording a scope
+   costs one test of a global flag */
+class CpuProfiler
+{
+private:
+	struct Event
+	{
+		const char* Name;
+		int64_t Begin, End;	// nanoseconds since the profiler started
+	};
+
+	struct ThreadBuffer
+	{
+		static const size_t Capacity = 1 << 16;
+
+		std::unique_ptr<Event[]> Events;
+		/* Only the owning thread writes, readers see events below Count */
+		std::atomic<size_t> Count;
+		std::atomic<unsigned int> Dropped;
+		/* The capture Count and Dropped belong to, behind s_Generation until the owner
+		   records its first event since Start and resets them */
+		std::atomic<unsigned int> Generation;
+		unsigned int ThreadID;
+		std::string Name;
+	};
+
+	static std::atomic<bool> s_Enabled;
+	/* Bumped by Start, every capture has its own */
+	static std::atomic<unsigned int> s_Generation;
+
+	/* Buffers outlive their threads so a finished worker's events still get written */
+	static std::mutex s_BuffersMutex;
+	static std::vector<std::unique_ptr<ThreadBuffer>> s_Buffers;
+	/* This thread's buffer, registered on its first event */
+	static thread_local ThreadBuffer* s_ThreadBuffer;
+
+	/* CaptureFrames state, main thread only */
+	static int s_CaptureFramesLeft;
+	static std::string s_CapturePath;
+
+public:
+	inline static bool IsEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+
+	/* Throw away what was recorded and start again, or stop. Call between frames; each
+	   thread drops its old events itself on the first one it records afterwards */
+	static void Start();
+	static void Stop();
+
+	/* Record the next frameCount frames and write them to path, OnFrameEnd counts them off */
+	static void CaptureFrames(int frameCount, const std::string& path);
+	static void OnFrameEnd();
+	inline static bool IsCapturing() { return s_CaptureFramesLeft > 0; }
+
+	/* Shown as the track name in the trace, call from the thread itself */
+	static void SetThreadName(const std::string& name);
+
+	/* Everything recorded since Start, stop first for a consistent snapshot */
+	static bool WriteChromeTrace(const std::string& path);
+
+	static int64_t Now();
+	static void Record(const char* name, int64_t begin, int64_t end);
+
+private:
+	static ThreadBuffer& GetThreadBuffer();
+};
+
+class CpuProfileScope
+{
+private:
+	const char* m_Name;
+	int64_t m_Begin;
+
+public:
+	/* The flag is only tested here, the destructor just checks what was stored */
+	CpuProfileScope(const char* name)
+		: m_Name(nullptr), m_Begin(0)
+	{
+		if (CpuProfiler::IsEnabled())
+		{
+			m_Name = name;
+			m_Begin = CpuProfiler::Now();
+		}
+	}
+	~CpuProfileScope()
+	{
+		if (m_Name)
+			CpuProfiler::Record(m_Name, m_Begin, CpuProfiler::Now());
+	}
+};
+
+#if CPU_PROFILING
+	#define CPU_PROFILE_CONCAT_(a, b) a##b
+	#define CPU_PROFILE_CONCAT(a, b) CPU_PROFILE_CONCAT_(a, b)
+	/* Times the rest of the enclosing block, name has to outlive the trace (a literal) */
+	#define CPU_PROFILE_SCOPE(name) CpuProfileScope CPU_PROFILE_CONCAT(cpuProfileScope, __LINE__)(name)
+#else
+	#define CPU_PROFILE_SCOPE(name)
+#endif
@@ -0,0 +1,177 @@
+#include "FrameTimer.h"
+
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+/* Longest delta Tick hands out */
+static const float s_MaxDeltaTime = 0.25f;
+
+/* Sleeps overshoot by up to a scheduler tick (15 ms on a default Windows timer), so the
+   limiter only sleeps until this close to the deadline and yields for the rest */
+static const std::chrono::microseconds s_SpinTime(2000);
+
+FrameTimer::FrameTimer(FramePacing pacing, int frameLimit)
+	: m_Pacing(pacing), m_FrameLimit(std::max(1, frameLimit)), m_Started(false),
+	  m_Offset(0), m_Count(0), m_Stats{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0 }
+{
+	std::fill(m_History, m_History + HistoryLength, 0.0f);
+}
+
+float FrameTimer::Tick()
+{
+	if (m_Pacing == FramePacing::Limited && m_Started)
+		WaitForDeadline();
+
+	Clock::time_point now = Clock::now();
+	if (!m_Started)
+	{
+		m_Started = true;
+		m_LastTick = now;
+		m_Deadline = now + GetFramePeriod();
+		return 0.0f;
+	}
+
+	double seconds = std::chrono::duration<double>(now - m_LastTick).count();
+	m_LastTick = now;
+
+	m_History[m_Offset] = (float)(seconds * 1000.0);
+	m_Offset = (m_Offset + 1) % HistoryLength;
+	if (m_Count < HistoryLength)
+		m_Count++;
+	UpdateStats();
+
+	return std::min((float)seconds, s_MaxDeltaTime);
+}
+
+void FrameTimer::WaitForDeadline()
+{
+	Clock::duration period = GetFramePeriod();
+
+	/* A frame that ran a little late is made up on the next one, which keeps the average
+	   rate; more than a whole frame behind, start over from now rather than rushing */
+	Clock::time_point now = Clock::now();
+	if (now - m_Deadline > period)
+		m_Deadline = now;
+
+	while ((now = Clock::now()) < m_Deadline)
+	{
+		if (m_Deadline - now > s_SpinTime)
+			std::this_thread::sleep_for(m_Deadline - now - s_SpinTime);
+		else
+			std::this_thread::yield();
+	}
+	m_Deadline += period;
+}
+
+void FrameTimer::SetPacing(FramePacing pacing, int frameLimit)
+{
+	m_Pacing = pacing;
+	m_FrameLimit = std::max(1, frameLimit);
+	m_Deadline = m_LastTick + GetFramePeriod();
+}
+
+FrameTimer::Clock::duration FrameTimer::GetFramePeriod() const
+{
+	return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_FrameLimit));
+}
+
+void FrameTimer::UpdateStats()
+{
+	/* Order doesn't matter here, and until the ring wraps the filled entries are the first m_Count */
+	float sorted[HistoryLength];
+	std::copy(m_History, m_History + m_Count, sorted);
+	std::sort(sorted, sorted + m_Count);
+
+	double total = 0.0;
+	for (int i = 0; i < m_Count; i++)
+		total += sorted[i];
+	float average = (float)(total / m_Count);
+
+	double variance = 0.0;
+	unsigned int hitches = 0;
+	float median = sorted[m_Count / 2];
+	for (int i = 0; i < m_Count; i++)
+	{
+		variance += (sorted[i] - average) * (sorted[i] - average);
+		if (sorted[i] > 2.0f * median)
+			hitches++;
+	}
+
+	m_Stats.AverageMs = average;
+	m_Stats.MinMs = sorted[0];
+	m_Stats.MaxMs = sorted[m_Count - 1];
+	m_Stats.P99Ms = sorted[std::max(0, (int)std::ceil(0.99 * m_Count) - 1)];
+	m_Stats.JitterMs = (float)std::sqrt(variance / m_Count);
+	m_Stats.Hitches = hitches;
+}
+
+bool FrameTimer::OnImGuiRender()
+{
+	bool changed = false;
+
+	int pacing = (int)m_Pacing;
+	if (ImGui::Combo("Pacing", &pacing, "Uncapped\0VSync\0Limited\0"))
+		changed = true;
+	int frameLimit = m_FrameLimit;
+	if (pacing == (int)FramePacing::Limited && ImGui::SliderInt("Frame limit", &frameLimit, 10, 500))
+		changed = true;
+	if (changed)
+		SetPacing((FramePacing)pacing, frameLimit);
+
+	if (m_Count > 0)
+	{
+		ImGui::Text("%.3f ms/frame (%.1f FPS), min %.3f, max %.3f", m_Stats.AverageMs, 1000.0f / m_Stats.AverageMs,
+			m_Stats.MinMs, m_Stats.MaxMs);
+		ImGui::Text("p99 %.3f ms, jitter %.3f ms, %u hitches in the last %d frames", m_Stats.P99Ms, m_Stats.JitterMs,
+			m_Stats.Hitches, m_Count);
+
+		char overlay[32];
+		snprintf(overlay, sizeof(overlay), "%.3f ms", m_History[(m_Offset + HistoryLength - 1) % HistoryLength]);
+		ImGui::PlotLines("##FrameTimerGraph", m_History, HistoryLength, m_Offset, overlay, 0.0f, FLT_MAX, ImVec2(0.0f, 80.0f));
+	}
+	return changed;
+}
+
+FixedTimestep::FixedTimestep(float step, int maxSteps)
+	: m_Step(step), m_MaxSteps(std::max(1, maxSteps)), m_Accumulator(0.0), m_DroppedSteps(0)
+{
+}
+
+int FixedTimestep::Advance(float deltaTime)
+{
+	m_Accumulator += deltaTime;
+
+	int steps = 0;
+	while (m_Accumulator >= m_Step)
+	{
+		if (steps == m_MaxSteps)
+		{
+			m_DroppedSteps += (unsigned int)(m_Accumulator / m_Step);
+			m_Accumulator = std::fmod(m_Accumulator, (double)m_Step);
+			break;
+		}
+		m_Accumulator -= m_Step;
+		steps++;
+	}
+	return steps;
+}
+
+void FixedTimestep::SetStep(float step)
+{
+	m_Step = step;
+	/* A shorter step can leave more than a step accumulated, keep alpha inside 0..1 */
+	m_Accumulator = std::fmod(m_Accumulator, (double)m_Step);
+}
+
+void FixedTimestep::OnImGuiRender()
+{
+	float rate = 1.0f / m_Step;
+	if (ImGui::SliderFloat("Simulation Hz", &rate, 5.0f, 240.0f, "%.0f"))
+		SetStep(1.0f / rate);
+	ImGui::Text("Interpolation alpha %.2f, %u steps dropped", GetAlpha(), m_DroppedSteps);
+}
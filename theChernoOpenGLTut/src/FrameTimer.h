@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+
+enum class FramePacing
+{
+	Uncapped,	// swap interval 0, as fast as the GPU goes
+	VSync,		// swap interval 1, the display decides
+	Limited		// swap interval 0, FrameTimer sleeps up to a target rate
+};
+
+/* Real frame delta from a steady high resolution clock, optional frame limiting and
+   rolling frame pacing statistics. Swap intervals are the window's business: check
+   GetPacing after OnImGuiRender reports a change */
+class FrameTimer
+{
+public:
+	static const int HistoryLength = 240;
+
+	struct Stats
+	{
+		float AverageMs, MinMs, MaxMs;
+		float P99Ms;
+		float JitterMs;				// standard deviation of the frame interval
+		unsigned int Hitches;		// frames over twice the median, across the history
+	};
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	FramePacing m_Pacing;
+	int m_FrameLimit;
+
+	bool m_Started;
+	Clock::time_point m_LastTick;
+	Clock::time_point m_Deadline;	// when the next frame may start, Limited only
+
+	float m_History[HistoryLength];	// frame intervals in milliseconds
+	int m_Offset;
+	int m_Count;
+	Stats m_Stats;
+
+public:
+	FrameTimer(FramePacing pacing = FramePacing::VSync, int frameLimit = 144);
+
+	/* Call once at the top of every frame. Returns seconds since the previous call, 0 the
+	   first time, capped so a breakpoint doesn't arrive as one enormous step. When
+	   Limited it first waits until the frame is due */
+	float Tick();
+
+	void SetPacing(FramePacing pacing, int frameLimit);
+	inline FramePacing GetPacing() const { return m_Pacing; }
+	inline int GetFrameLimit() const { return m_FrameLimit; }
+
+	inline const Stats& GetStats() const { return m_Stats; }
+
+	/* Pacing controls, statistics and a frame time graph, into the current window.
+	   True when the pacing changed */
+	bool OnImGuiRender();
+
+private:
+	Clock::duration GetFramePeriod() const;
+	void WaitForDeadline();
+	void UpdateStats();
+};
+
+/* Fixed rate simulation steps out of variable frame deltas. Whatever is left over is
+   the interpolation alpha between the last two steps */
+class FixedTimestep
+{
+private:
+	float m_Step;
+	int m_MaxSteps;
+	double m_Accumulator;
+	unsigned int m_DroppedSteps;
+
+public:
+	FixedTimestep(float step = 1.0f / 60.0f, int maxSteps = 8);
+
+	/* Add a frame's delta and return how many steps to run. Beyond maxSteps the rest of
+	   the time is dropped, so a slow frame can't make the next one slower still */
+	int Advance(float deltaTime);
+
+	/* 0 is the state after the last step, 1 a whole step further */
+	inline float GetAlpha() const { return (float)(m_Accumulator / m_Step); }
+
+	inline float GetStep() const { return m_Step; }
+	void SetStep(float step);
+	inline unsigned int GetDroppedSteps() const { return m_DroppedSteps; }
+
+	/* Step rate slider, into the current window */
+	void OnImGuiRender();
+};
@@ -0,0 +1,242 @@
+#include "Framebuffer.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static void CheckStatus(const char* name, int width, int height, unsigned int samples)
+{
+	GLenum status;
+	GLCall(status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Warning: " << name << " framebuffer " << width << "x" << height << " (" << samples
+			<< " samples) is incomplete (0x" << std::hex << status << std::dec << ")" << std::endl;
+	}
+}
+
+Framebuffer::Framebuffer(int width, int height, const FramebufferSpec& spec)
+	: m_RendererID(0), m_ResolveID(0), m_ColourAttachment(0), m_ColourRenderbuffer(0), m_DepthAttachment(0),
+	  m_Width(width), m_Height(height), m_Samples(1), m_Spec(spec),
+	  m_PreviousReadFramebuffer(0), m_PreviousDrawFramebuffer(0), m_PreviousViewport{ 0, 0, 0, 0 }, m_PixelBuffer(0), m_ReadbackFence(nullptr)
+{
+	Create();
+}
+
+Framebuffer::~Framebuffer()
+{
+	Release();
+	if (m_PixelBuffer)
+	{
+		GLCall(glDeleteBuffers(1, &m_PixelBuffer));
+	}
+}
+
+void Framebuffer::Create()
+{
+	/* Creating attachments shouldn't change which target the caller is drawing to */
+	GLint previousRead, previousDraw;
+	GLCall(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead));
+	GLCall(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDraw));
+
+	GLint maxSamples;
+	GLCall(glGetIntegerv(GL_MAX_SAMPLES, &maxSamples));
+	m_Samples = std::max(1u, std::min(m_Spec.Samples, (unsigned int)maxSamples));
+
+	GLCall(glGenTextures(1, &m_ColourAttachment));
+	StateCache::Get().BindTexture2D(0, m_ColourAttachment);
+	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	StateCache::Get().BindTexture2D(0, 0);
+
+	GLCall(glGenFramebuffers(1, &m_ResolveID));
+	GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_ResolveID));
+	GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColourAttachment, 0));
+
+	if (m_Samples > 1)
+	{
+		CheckStatus("resolve", m_Width, m_Height, 1);
+
+		GLCall(glGenFramebuffers(1, &m_RendererID));
+		GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+		GLCall(glGenRenderbuffers(1, &m_ColourRenderbuffer));
+		GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColourRenderbuffer));
+		GLCall(glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_Samples, GL_RGBA8, m_Width, m_Height));
+		GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColourRenderbuffer));
+	}
+	else
+	{
+		m_RendererID = m_ResolveID;
+	}
+
+	if (m_Spec.DepthStencil)
+	{
+		/* Depth is never resolved, so it only exists on the target that is drawn into */
+		GLCall(glGenRenderbuffers(1, &m_DepthAttachment));
+		GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment));
+		if (m_Samples > 1)
+		{
+			GLCall(glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_Samples, GL_DEPTH24_STENCIL8, m_Width, m_Height));
+		}
+		else
+		{
+			GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height));
+		}
+		GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthAttachment));
+	}
+	GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+	CheckStatus(m_Samples > 1 ? "multisampled" : "single sampled", m_Width, m_Height, m_Samples);
+	GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead));
+	GLCall(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDraw));
+}
+
+void Framebuffer::Release()
+{
+	if (m_ReadbackFence)
+	{
+		GLCall(glDeleteSync(m_ReadbackFence));
+		m_ReadbackFence = nullptr;
+	}
+
+	if (m_RendererID != m_ResolveID)
+	{
+		GLCall(glDeleteFramebuffers(1, &m_RendererID));
+	}
+	GLCall(glDeleteFramebuffers(1, &m_ResolveID));
+	GLCall(glDeleteTextures(1, &m_ColourAttachment));
+	StateCache::Get().OnTextureDeleted(m_ColourAttachment);
+	GLCall(glDeleteRenderbuffers(1, &m_ColourRenderbuffer));
+	GLCall(glDeleteRenderbuffers(1, &m_DepthAttachment));
+
+	m_RendererID = m_ResolveID = m_ColourAttachment = m_ColourRenderbuffer = m_DepthAttachment = 0;
+}
+
+void Framebuffer::Resize(int width, int height)
+{
+	width = std::max(1, width);
+	height = std::max(1, height);
+	if (width == m_Width && height == m_Height)
+		return;
+
+	Release();
+	m_Width = width;
+	m_Height = height;
+	Create();
+}
+
+void Framebuffer::Bind() const
+{
+	GLCall(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &m_PreviousReadFramebuffer));
+	GLCall(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_PreviousDrawFramebuffer));
+	GLCall(glGetIntegerv(GL_VIEWPORT, m_PreviousViewport));
+	GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+	GLCall(glViewport(0, 0, m_Width, m_Height));
+}
+
+void Framebuffer::Unbind() const
+{
+	GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_PreviousReadFramebuffer));
+	GLCall(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_PreviousDrawFramebuffer));
+	GLCall(glViewport(m_PreviousViewport[0], m_PreviousViewport[1], m_PreviousViewport[2], m_PreviousViewport[3]));
+}
+
+void Framebuffer::Resolve() const
+{
+	if (m_Samples == 1)
+		return;
+
+	GLint previousRead, previousDraw;
+	GLCall(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead));
+	GLCall(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDraw));
+
+	GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID));
+	GLCall(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_ResolveID));
+	GLCall(glBlitFramebuffer(0, 0, m_Width, m_Height, 0, 0, m_Width, m_Height, GL_COLOR_BUFFER_BIT, GL_NEAREST));
+
+	GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead));
+	GLCall(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDraw));
+}
+
+void Framebuffer::ReadPixels(std::vector<unsigned char>& pixels) const
+{
+	Resolve();
+	pixels.resize((size_t)m_Width * m_Height * 4);
+
+	GLint previousRead;
+	GLCall(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead));
+	GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_ResolveID));
+	GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+	GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data()));
+	GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead));
+}
+
+void Framebuffer::ReadPixelsInto(unsigned int pixelBuffer) const
+{
+	Resolve();
+
+	GLint previousRead;
+	GLCall(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead));
+	GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_ResolveID));
+	GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer));
+	GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+	GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead));
+}
+
+void Framebuffer::BeginReadback()
+{
+	/* Only the latest request is kept */
+	if (m_ReadbackFence)
+	{
+		GLCall(glDeleteSync(m_ReadbackFence));
+		m_ReadbackFence = nullptr;
+	}
+
+	if (!m_PixelBuffer)
+	{
+		GLCall(glGenBuffers(1, &m_PixelBuffer));
+	}
+
+	/* Respecifying the storage orphans a copy the driver may still be reading from */
+	GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_PixelBuffer));
+	GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, (size_t)m_Width * m_Height * 4, nullptr, GL_STREAM_READ));
+	GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+	ReadPixelsInto(m_PixelBuffer);
+	GLCall(m_ReadbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+}
+
+bool Framebuffer::TryGetReadback(std::vector<unsigned char>& pixels)
+{
+	if (!m_ReadbackFence)
+		return false;
+
+	/* A zero timeout only polls, the flush makes sure the fence is ever reached */
+	GLenum result;
+	GLCall(result = glClientWaitSync(m_ReadbackFence, GL_SYNC_FLUSH_COMMANDS_BIT, 0));
+	if (result == GL_TIMEOUT_EXPIRED)
+		return false;
+
+	GLCall(glDeleteSync(m_ReadbackFence));
+	m_ReadbackFence = nullptr;
+	if (result == GL_WAIT_FAILED)
+		return false;
+
+	size_t size = (size_t)m_Width * m_Height * 4;
+	pixels.resize(size);
+	GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_PixelBuffer));
+	const void* mapped;
+	GLCall(mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+	if (mapped)
+		memcpy(pixels.data(), mapped, size);
+	GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+	GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+	return mapped != nullptr;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <vector>
+
+/* Attachments of a Framebuffer, the defaults are a plain single sampled target */
+struct FramebufferSpec
+{
+	/* Above 1 draws go to multisampled renderbuffers and Resolve blits them into the colour texture.
+	   Clamped to GL_MAX_SAMPLES */
+	unsigned int Samples = 1;
+	bool DepthStencil = true;
+};
+
+/* Offscreen render target with an RGBA8 colour texture and an optional depth/stencil renderbuffer */
+class Framebuffer
+{
+private:
+	unsigned int m_RendererID;			// drawn into, multisampled when m_Samples > 1
+	unsigned int m_ResolveID;			// owns the colour texture, m_RendererID itself without MSAA
+	unsigned int m_ColourAttachment;
+	unsigned int m_ColourRenderbuffer;	// multisampled colour, 0 without MSAA
+	unsigned int m_DepthAttachment;
+	int m_Width, m_Height;
+	unsigned int m_Samples;
+	FramebufferSpec m_Spec;
+
+	/* Whatever Bind replaced, so Unbind works inside another target, e.g. under --headless.
+	   Read and draw are kept apart since a caller can have different ones bound */
+	mutable int m_PreviousReadFramebuffer, m_PreviousDrawFramebuffer;
+	mutable int m_PreviousViewport[4];
+
+	/* Readback into a pixel pack buffer, finished when the fence is signalled */
+	unsigned int m_PixelBuffer;
+	GLsync m_ReadbackFence;
+
+public:
+	Framebuffer(int width, int height, const FramebufferSpec& spec = FramebufferSpec());
+	~Framebuffer();
+
+	Framebuffer(const Framebuffer&) = delete;
+	Framebuffer& operator=(const Framebuffer&) = delete;
+
+	/* Recreates the attachments, contents are lost and a pending readback is dropped */
+	void Resize(int width, int height);
+
+	/* Also sets the viewport to cover the whole target */
+	void Bind() const;
+	void Unbind() const;
+
+	/* Make the colour texture current with what was drawn, nothing to do without MSAA */
+	void Resolve() const;
+
+	/* Resolved colour as tightly packed RGBA8, bottom row first. Waits for the GPU to finish drawing */
+	void ReadPixels(std::vector<unsigned char>& pixels) const;
+
+	/* Resolve and queue a copy of the colour into pixelBuffer, which must already hold
+	   GetWidth() * GetHeight() * 4 bytes. Nothing waits, fence it to know when it lands */
+	void ReadPixelsInto(unsigned int pixelBuffer) const;
+
+	/* Resolve and start copying the colour into a pixel buffer without waiting. TryGetReadback
+	   returns false until the copy has landed, then fills pixels once */
+	void BeginReadback();
+	bool TryGetReadback(std::vector<unsigned char>& pixels);
+	inline bool IsReadbackPending() const { return m_ReadbackFence != nullptr; }
+
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+	inline unsigned int GetSamples() const { return m_Samples; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline unsigned int GetColourAttachment() const { return m_ColourAttachment; }
+	inline const FramebufferSpec& GetSpec() const { return m_Spec; }
+
+private:
+	void Create();
+	void Release();
+};
@@ -0,0 +1,187 @@
+#include "GpuProfiler.h"
+
+#include "Renderer.h"
+
+#include "imgui/imgui.h"
+
+#include <cstdio>
+
+GpuProfiler::GpuProfiler()
+	: m_FrameIndex(0), m_Recording(false), m_SkippedFrames(0)
+{
+	for (Frame& frame : m_Frames)
+	{
+		frame.QueriesUsed = 0;
+		frame.Pending = false;
+	}
+}
+
+GpuProfiler& GpuProfiler::Get()
+{
+	static GpuProfiler profiler;
+	return profiler;
+}
+
+void GpuProfiler::BeginFrame()
+{
+	m_FrameIndex++;
+	Frame& frame = m_Frames[m_FrameIndex % FrameLatency];
+
+	if (frame.Pending)
+	{
+		/* The frame scope's end is the last query issued, once it is ready all of them are */
+		GLint available = 0;
+		GLCall(glGetQueryObjectiv(frame.Scopes.front().EndQuery, GL_QUERY_RESULT_AVAILABLE, &available));
+		if (!available)
+		{
+			/* Still in flight, reusing its queries would stall */
+			m_Recording = false;
+			m_SkippedFrames++;
+			return;
+		}
+		Collect(frame);
+	}
+
+	frame.Scopes.clear();
+	frame.QueriesUsed = 0;
+	frame.Pending = false;
+	m_Stack.clear();
+	m_Recording = true;
+	PushScope("Frame");
+}
+
+void GpuProfiler::EndFrame()
+{
+	if (!m_Recording)
+		return;
+
+	while (!m_Stack.empty())
+		PopScope();
+	m_Frames[m_FrameIndex % FrameLatency].Pending = true;
+	m_Recording = false;
+}
+
+void GpuProfiler::PushScope(const char* name)
+{
+	if (!m_Recording)
+		return;
+
+	Frame& frame = m_Frames[m_FrameIndex % FrameLatency];
+	Scope scope;
+	scope.Name = name;
+	scope.Depth = (int)m_Stack.size();
+	scope.BeginQuery = NextQuery(frame);
+	scope.EndQuery = NextQuery(frame);
+	GLCall(glQueryCounter(scope.BeginQuery, GL_TIMESTAMP));
+
+	m_Stack.push_back((int)frame.Scopes.size());
+	frame.Scopes.push_back(scope);
+}
+
+void GpuProfiler::PopScope()
+{
+	if (!m_Recording || m_Stack.empty())
+		return;
+
+	Frame& frame = m_Frames[m_FrameIndex % FrameLatency];
+	GLCall(glQueryCounter(frame.Scopes[m_Stack.back()].EndQuery, GL_TIMESTAMP));
+	m_Stack.pop_back();
+}
+
+unsigned int GpuProfiler::NextQuery(Frame& frame)
+{
+	if (frame.QueriesUsed == frame.Queries.size())
+	{
+		unsigned int query;
+		GLCall(glGenQueries(1, &query));
+		frame.Queries.push_back(query);
+	}
+	return frame.Queries[frame.QueriesUsed++];
+}
+
+void GpuProfiler::Collect(Frame& frame)
+{
+	m_Results.clear();
+	for (const Scope& scope : frame.Scopes)
+	{
+		GLuint64 begin, end;
+		GLCall(glGetQueryObjectui64v(scope.BeginQuery, GL_QUERY_RESULT, &begin));
+		GLCall(glGetQueryObjectui64v(scope.EndQuery, GL_QUERY_RESULT, &end));
+		float milliseconds = (end - begin) / 1.0e6f;
+		m_Results.push_back({ scope.Name, scope.Depth, milliseconds });
+
+		/* Scopes missing from a frame keep their old values, the graph only moves when they run */
+		History& history = m_History.emplace(scope.Name, History{ {}, 0, 0, 0.0f }).first->second;
+		history.Values[history.Offset] = milliseconds;
+		history.Offset = (history.Offset + 1) % HistoryLength;
+		if (history.Count < HistoryLength)
+			history.Count++;
+
+		float total = 0.0f;
+		for (float value : history.Values)
+			total += value;
+		history.Average = total / history.Count;
+	}
+}
+
+void GpuProfiler::OnImGuiRender()
+{
+	ImGui::Begin("GPU Profiler");
+
+	ImGui::Columns(3, "GpuProfilerScopes");
+	ImGui::Text("Scope");
+	ImGui::NextColumn();
+	ImGui::Text("ms");
+	ImGui::NextColumn();
+	ImGui::Text("avg ms");
+	ImGui::NextColumn();
+	ImGui::Separator();
+
+	for (const ScopeResult& result : m_Results)
+	{
+		/* Only the names are indented, the numbers stay lined up */
+		if (result.Depth > 0)
+			ImGui::Indent(result.Depth * 12.0f);
+		if (ImGui::Selectable(result.Name.c_str(), m_Selected == result.Name, ImGuiSelectableFlags_SpanAllColumns))
+			m_Selected = result.Name;
+		if (result.Depth > 0)
+			ImGui::Unindent(result.Depth * 12.0f);
+		ImGui::NextColumn();
+		ImGui::Text("%.3f", result.Milliseconds);
+		ImGui::NextColumn();
+		ImGui::Text("%.3f", m_History[result.Name].Average);
+		ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+	ImGui::Separator();
+
+	const std::string& graphed = m_Selected.empty() ? std::string("Frame") : m_Selected;
+	auto history = m_History.find(graphed);
+	if (history != m_History.end())
+	{
+		char overlay[64];
+		snprintf(overlay, sizeof(overlay), "%s %.3f ms avg", graphed.c_str(), history->second.Average);
+		ImGui::PlotLines("##GpuProfilerGraph", history->second.Values, HistoryLength, history->second.Offset,
+			overlay, 0.0f, FLT_MAX, ImVec2(0.0f, 80.0f));
+	}
+	ImGui::Text("Results are %d frames old, %u frames skipped waiting on the GPU", FrameLatency, m_SkippedFrames);
+
+	ImGui::End();
+}
+
+void GpuProfiler::Shutdown()
+{
+	for (Frame& frame : m_Frames)
+	{
+		if (!frame.Queries.empty())
+		{
+			GLCall(glDeleteQueries((GLsizei)frame.Queries.size(), frame.Queries.data()));
+		}
+		frame.Queries.clear();
+		frame.Scopes.clear();
+		frame.QueriesUsed = 0;
+		frame.Pending = false;
+	}
+	m_Recording = false;
+	m_Stack.clear();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+/* Per-scope GPU times from glQueryCounter(GL_TIMESTAMP) pairs. GL_TIME_ELAPSED queries
+   can't be nested, timestamps can, so scopes form a tree under the whole frame.
+   Results are read FrameLatency frames later; if they still aren't there that frame
+   goes unrecorded rather than waiting on the GPU */
+class GpuProfiler
+{
+public:
+	static const int FrameLatency = 4;
+	static const int HistoryLength = 120;
+
+	struct ScopeResult
+	{
+		std::string Name;
+		int Depth;				// 0 is the frame itself
+		float Milliseconds;
+	};
+
+private:
+	struct Scope
+	{
+		const char* Name;
+		int Depth;
+		unsigned int BeginQuery, EndQuery;
+	};
+
+	struct Frame
+	{
+		std::vector<Scope> Scopes;
+		std::vector<unsigned int> Queries;	// grows to the most any frame needed
+		unsigned int QueriesUsed;
+		bool Pending;
+	};
+
+	/* Rolling milliseconds of every scope seen, by name */
+	struct History
+	{
+		float Values[HistoryLength];
+		int Offset;
+		int Count;		// values filled in so far, up to HistoryLength
+		float Average;
+	};
+
+	Frame m_Frames[FrameLatency];
+	unsigned int m_FrameIndex;
+	bool m_Recording;
+	std::vector<int> m_Stack;	// open scopes of the current frame
+
+	std::vector<ScopeResult> m_Results;
+	std::map<std::string, History> m_History;
+	std::string m_Selected;
+	unsigned int m_SkippedFrames;
+
+	GpuProfiler();
+
+public:
+	static GpuProfiler& Get();
+
+	/* Bracket everything drawn in a frame, BeginFrame also collects the results of an earlier one */
+	void BeginFrame();
+	void EndFrame();
+
+	/* Outside BeginFrame/EndFrame these do nothing */
+	void PushScope(const char* name);
+	void PopScope();
+
+	/* Newest frame that came back, parents before children */
+	inline const std::vector<ScopeResult>& GetResults() const { return m_Results; }
+
+	/* Hierarchical table and a rolling graph of the selected scope in their own window */
+	void OnImGuiRender();
+
+	/* Delete the queries while the context is still current */
+	void Shutdown();
+
+private:
+	unsigned int NextQuery(Frame& frame);
+	void Collect(Frame& frame);
+};
+
+class GpuProfileScope
+{
+public:
+	GpuProfileScope(const char* name) { GpuProfiler::Get().PushScope(name); }
+	~GpuProfileScope() { GpuProfiler::Get().PopScope(); }
+};
+
+#define GPU_PROFILE_CONCAT_(a, b) a##b
+#define GPU_PROFILE_CONCAT(a, b) GPU_PROFILE_CONCAT_(a, b)
+
+/* Times the rest of the enclosing block, name has to outlive the frame (a literal) */
+#define GPU_PROFILE_SCOPE(name) GpuProfileScope GPU_PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
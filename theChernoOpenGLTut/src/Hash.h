@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* 64-bit FNV-1a */
+static const uint64_t HashOffsetBasis = 14695981039346656037ull;
+static const uint64_t HashPrime = 1099511628211ull;
+
+/* Compile-time hash of a string literal, e.g. HashString("u_Model") */
+constexpr uint64_t HashString(const char* str, uint64_t hash = HashOffsetBasis)
+{
+	return *str ? HashString(str + 1, (hash ^ (uint64_t)(unsigned char)*str) * HashPrime) : hash;
+}
+
+/* Runtime hash of a byte range, pass the previous result as seed to combine ranges */
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = HashOffsetBasis)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ bytes[i]) * HashPrime;
+	return hash;
+}
@@ -0,0 +1,140 @@
+#include "HeadlessContext.h"
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+	/* Keep Xlib's None/Bool/Status macros out, nothing here needs X11 */
+	#define EGL_NO_X11
+	#define MESA_EGL_NO_X11_HEADERS
+	#include <EGL/egl.h>
+	#include <EGL/eglext.h>
+#endif
+
+HeadlessContext::HeadlessContext(bool debug)
+	: m_Backend(Backend::Unavailable), m_Display(nullptr), m_Context(nullptr), m_Window(nullptr)
+{
+	if (CreateEGL(debug))
+		m_Backend = Backend::SurfacelessEGL;
+	else if (CreateHiddenWindow(debug))
+		m_Backend = Backend::HiddenWindow;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+#ifdef __linux__
+	if (m_Display)
+	{
+		eglMakeCurrent((EGLDisplay)m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (m_Context)
+			eglDestroyContext((EGLDisplay)m_Display, (EGLContext)m_Context);
+		eglTerminate((EGLDisplay)m_Display);
+	}
+#endif
+	if (m_Window)
+	{
+		glfwDestroyWindow(m_Window);
+		glfwTerminate();
+	}
+}
+
+const char* HeadlessContext::GetBackendName() const
+{
+	switch (m_Backend)
+	{
+	case Backend::SurfacelessEGL: return "surfaceless EGL";
+	case Backend::HiddenWindow: return "hidden GLFW window";
+	default: return "none";
+	}
+}
+
+bool HeadlessContext::CreateEGL(bool debug)
+{
+#ifdef __linux__
+	/* Prefer the surfaceless platform so no X or Wayland server is touched at all */
+	EGLDisplay display = EGL_NO_DISPLAY;
+	const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (clientExtensions && strstr(clientExtensions, "EGL_MESA_platform_surfaceless") && getPlatformDisplay)
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	if (display == EGL_NO_DISPLAY)
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	EGLint major, minor;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+	{
+		std::cout << "EGL: no display available" << std::endl;
+		return false;
+	}
+	m_Display = display;
+
+	/* Nothing is drawn to an EGL surface, a config only has to be able to make GL contexts */
+	const EGLint configAttribs[] =
+	{
+		EGL_SURFACE_TYPE, 0,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint configCount = 0;
+	if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0 || !eglBindAPI(EGL_OPENGL_API))
+	{
+		std::cout << "EGL: no config for desktop OpenGL" << std::endl;
+		return false;
+	}
+
+	const EGLint contextAttribs[] =
+	{
+		EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+		EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+		EGL_CONTEXT_FLAGS_KHR, debug ? EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR : 0,
+		EGL_NONE
+	};
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+	if (context == EGL_NO_CONTEXT)
+	{
+		std::cout << "EGL: could not create a 3.3 core context (0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+		return false;
+	}
+	m_Context = context;
+
+	if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+	{
+		std::cout << "EGL: could not make the context current without a surface" << std::endl;
+		return false;
+	}
+	return true;
+#else
+	(void)debug;
+	return false;
+#endif
+}
+
+bool HeadlessContext::CreateHiddenWindow(bool debug)
+{
+	if (!glfwInit())
+		return false;
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	if (debug)
+		glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	m_Window = glfwCreateWindow(1, 1, "Headless", NULL, NULL);
+	if (!m_Window)
+	{
+		glfwTerminate();
+		return false;
+	}
+	glfwMakeContextCurrent(m_Window);
+	/* Frames are timed, not presented */
+	glfwSwapInterval(0);
+	return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+struct GLFWwindow;
+
+/* A current GL 3.3 core context with no window on screen, for running tests on machines
+   without a display. Surfaceless EGL first (Mesa llvmpipe is enough), which is only
+   built on Linux, then a hidden GLFW window. Rendering has to go to a Framebuffer */
+class HeadlessContext
+{
+public:
+	enum class Backend
+	{
+		Unavailable,
+		SurfacelessEGL,
+		HiddenWindow,
+	};
+
+private:
+	Backend m_Backend;
+	void* m_Display;	// EGLDisplay
+	void* m_Context;	// EGLContext
+	GLFWwindow* m_Window;
+
+public:
+	HeadlessContext(bool debug);
+	~HeadlessContext();
+
+	HeadlessContext(const HeadlessContext&) = delete;
+	HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+	inline bool IsValid() const { return m_Backend != Backend::Unavailable; }
+	inline Backend GetBackend() const { return m_Backend; }
+	const char* GetBackendName() const;
+
+private:
+	bool CreateEGL(bool debug);
+	bool CreateHiddenWindow(bool debug);
+};
@@ -0,0 +1,109 @@
+#include "ImageWriter.h"
+
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+static uint32_t Crc32(const unsigned char* data, size_t size, uint32_t crc = 0)
+{
+	/* A local static is initialised exactly once even with the ReadbackQueue worker writing PNGs too */
+	static const std::array<uint32_t, 256> table = []()
+	{
+		std::array<uint32_t, 256> result;
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t c = i;
+			for (int k = 0; k < 8; k++)
+				c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			result[i] = c;
+		}
+		return result;
+	}();
+
+	crc = ~crc;
+	for (size_t i = 0; i < size; i++)
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+static void PutBigEndian(std::vector<unsigned char>& out, uint32_t value)
+{
+	out.push_back((unsigned char)(value >> 24));
+	out.push_back((unsigned char)(value >> 16));
+	out.push_back((unsigned char)(value >> 8));
+	out.push_back((unsigned char)value);
+}
+
+static void WriteChunk(std::ofstream& stream, const char type[4], const std::vector<unsigned char>& data)
+{
+	std::vector<unsigned char> chunk;
+	chunk.reserve(data.size() + 12);
+	PutBigEndian(chunk, (uint32_t)data.size());
+	chunk.insert(chunk.end(), type, type + 4);
+	chunk.insert(chunk.end(), data.begin(), data.end());
+	/* The CRC covers the type and the data, not the length */
+	PutBigEndian(chunk, Crc32(chunk.data() + 4, chunk.size() - 4));
+	stream.write((const char*)chunk.data(), chunk.size());
+}
+
+bool WritePNG(const std::string& path, const unsigned char* pixels, int width, int height)
+{
+	if (width <= 0 || height <= 0)
+		return false;
+
+	std::ofstream stream(path, std::ios::binary);
+	if (!stream)
+		return false;
+
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	stream.write((const char*)signature, sizeof(signature));
+
+	std::vector<unsigned char> header;
+	PutBigEndian(header, (uint32_t)width);
+	PutBigEndian(header, (uint32_t)height);
+	header.insert(header.end(), { 8, 6, 0, 0, 0 });	// 8 bits, RGBA, deflate, adaptive filtering, no interlace
+	WriteChunk(stream, "IHDR", header);
+
+	/* Every scanline starts with its filter type, 0 is none. PNG is top row first */
+	size_t rowSize = (size_t)width * 4;
+	std::vector<unsigned char> scanlines((rowSize + 1) * height);
+	for (int y = 0; y < height; y++)
+	{
+		unsigned char* row = &scanlines[(rowSize + 1) * y];
+		row[0] = 0;
+		memcpy(row + 1, pixels + rowSize * (height - 1 - y), rowSize);
+	}
+
+	/* zlib stream made of stored deflate blocks, at most 65535 bytes each */
+	std::vector<unsigned char> data;
+	data.reserve(scanlines.size() + scanlines.size() / 65535 * 5 + 11);
+	data.push_back(0x78);
+	data.push_back(0x01);
+	uint32_t adlerA = 1, adlerB = 0;
+	for (size_t offset = 0; offset < scanlines.size();)
+	{
+		uint16_t length = (uint16_t)std::min<size_t>(scanlines.size() - offset, 65535);
+		bool final = offset + length == scanlines.size();
+		data.push_back(final ? 1 : 0);
+		data.push_back((unsigned char)length);
+		data.push_back((unsigned char)(length >> 8));
+		data.push_back((unsigned char)~length);
+		data.push_back((unsigned char)(~length >> 8));
+		data.insert(data.end(), scanlines.begin() + offset, scanlines.begin() + offset + length);
+
+		for (size_t i = offset; i < offset + length; i++)
+		{
+			adlerA = (adlerA + scanlines[i]) % 65521;
+			adlerB = (adlerB + adlerA) % 65521;
+		}
+		offset += length;
+	}
+	PutBigEndian(data, (adlerB << 16) | adlerA);
+	WriteChunk(stream, "IDAT", data);
+
+	WriteChunk(stream, "IEND", std::vector<unsigned char>());
+	return (bool)stream;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <string>
+
+/* RGBA8 pixels as a PNG, rows given bottom first the way glReadPixels returns them.
+   The image data is stored rather than deflated, so writing costs about as much as a
+   copy and keeps up with frame dumps; the files are roughly raw size */
+bool WritePNG(const std::string& path, const unsigned char* pixels, int width, int height);
@@ -1,6 +1,7 @@
 #include "IndexBuffer.h"
 
 #include "Renderer.h"
+#include "StateCache.h"
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
 	: m_Count(count)
@@ -8,21 +9,22 @@ IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
 	ASSERT(sizeof(unsigned int) == sizeof(GLuint));
 
 	GLCall(glGenBuffers(1, &m_RendererID));
-	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+	StateCache::Get().BindElementBuffer(m_RendererID);
 	GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW));
 }
 
 IndexBuffer::~IndexBuffer()
 {
 	GLCall(glDeleteBuffers(1, &m_RendererID));
+	StateCache::Get().OnBufferDeleted(m_RendererID);
 }
 
 void IndexBuffer::Bind() const
 {
-	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+	StateCache::Get().BindElementBuffer(m_RendererID);
 }
 
 void IndexBuffer::Unbind() const
 {
-	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+	StateCache::Get().BindElementBuffer(0);
 }
@@ -0,0 +1,100 @@
+#include "MipChain.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define MIPCHAIN_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define MIPCHAIN_SSE2 0
+#endif
+
+unsigned int GetMipLevelCount(int width, int height)
+{
+	unsigned int levels = 1;
+	int size = std::max(width, height);
+	while (size > 1)
+	{
+		size /= 2;
+		levels++;
+	}
+	return levels;
+}
+
+void DownsampleBox(const unsigned char* src, int width, int height, unsigned char* dst)
+{
+	int dstWidth = std::max(1, width / 2);
+	int dstHeight = std::max(1, height / 2);
+	size_t srcPitch = (size_t)width * 4;
+
+	for (int y = 0; y < dstHeight; y++)
+	{
+		/* A 1 pixel tall or wide source averages with itself */
+		const unsigned char* row0 = src + (size_t)std::min(y * 2, height - 1) * srcPitch;
+		const unsigned char* row1 = src + (size_t)std::min(y * 2 + 1, height - 1) * srcPitch;
+		unsigned char* out = dst + (size_t)y * dstWidth * 4;
+
+		int x = 0;
+#if MIPCHAIN_SSE2
+		/* Two destination pixels from four source pixels of each row */
+		if (width > 1)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i two = _mm_set1_epi16(2);
+			for (; x + 2 <= dstWidth; x += 2)
+			{
+				__m128i a = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+				__m128i b = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+
+				/* Vertical sums in 16 bits, source pixels 0,1 and 2,3 */
+				__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+				__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+				/* Horizontal sums, pixel 0 + 1 and pixel 2 + 3 */
+				__m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+				sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+
+				_mm_storel_epi64((__m128i*)(out + x * 4), _mm_packus_epi16(sum, zero));
+			}
+		}
+#endif
+		for (; x < dstWidth; x++)
+		{
+			int x0 = std::min(x * 2, width - 1) * 4;
+			int x1 = std::min(x * 2 + 1, width - 1) * 4;
+			for (int c = 0; c < 4; c++)
+				out[x * 4 + c] = (unsigned char)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+		}
+	}
+}
+
+std::vector<MipLevel> BuildMipChain(const unsigned char* pixels, int width, int height,
+	unsigned int levelCount, std::vector<unsigned char>& storage)
+{
+	levelCount = std::max(1u, std::min(levelCount, GetMipLevelCount(width, height)));
+
+	/* Size the storage up front so the level pointers stay valid */
+	size_t total = 0;
+	for (int w = width, h = height, i = 1; i < (int)levelCount; i++)
+	{
+		w = std::max(1, w / 2);
+		h = std::max(1, h / 2);
+		total += (size_t)w * h * 4;
+	}
+	storage.resize(total);
+
+	std::vector<MipLevel> levels;
+	levels.push_back({ pixels, width, height });
+
+	unsigned char* dst = storage.data();
+	for (unsigned int i = 1; i < levelCount; i++)
+	{
+		const MipLevel& previous = levels.back();
+		DownsampleBox(previous.Pixels, previous.Width, previous.Height, dst);
+
+		MipLevel level = { dst, std::max(1, previous.Width / 2), std::max(1, previous.Height / 2) };
+		dst += (size_t)level.Width * level.Height * 4;
+		levels.push_back(level);
+	}
+	return levels;
+}
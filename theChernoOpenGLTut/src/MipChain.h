@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+/* One RGBA8 level of a mip chain, Pixels points into storage owned by the caller */
+struct MipLevel
+{
+	const unsigned char* Pixels;
+	int Width, Height;
+};
+
+/* Levels from width x height down to 1x1 */
+unsigned int GetMipLevelCount(int width, int height);
+
+/* 2x2 box filter of an RGBA8 image into one of half the size (rounded down, at least 1).
+   Uses SSE2 where available */
+void DownsampleBox(const unsigned char* src, int width, int height, unsigned char* dst);
+
+/* Builds levels 1 to levelCount - 1 of pixels into storage and returns every level, level 0 included */
+std::vector<MipLevel> BuildMipChain(const unsigned char* pixels, int width, int height,
+	unsigned int levelCount, std::vector<unsigned char>& storage);
@@ -0,0 +1,184 @@
+#include "ReadbackQueue.h"
+
+#include "CpuProfiler.h"
+#include "Framebuffer.h"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cstring>
+
+ReadbackQueue::ReadbackQueue(unsigned int slotCount, Callback callback)
+	: m_Oldest(0), m_InFlight(0), m_NextIndex(0), m_Callback(std::move(callback)),
+	  m_Running(true), m_Busy(false), m_Stats{ 0, 0, 0 }
+{
+	m_Slots.resize(std::max(1u, slotCount));
+	for (Slot& slot : m_Slots)
+	{
+		GLCall(glGenBuffers(1, &slot.PixelBuffer));
+		slot.Capacity = 0;
+		slot.Fence = nullptr;
+	}
+	m_MaxQueued = m_Slots.size() * 2;
+
+	m_Worker = std::thread(&ReadbackQueue::Run, this);
+}
+
+ReadbackQueue::~ReadbackQueue()
+{
+	Flush();
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Running = false;
+	}
+	m_Wake.notify_all();
+	m_Worker.join();
+
+	for (Slot& slot : m_Slots)
+	{
+		GLCall(glDeleteBuffers(1, &slot.PixelBuffer));
+	}
+}
+
+bool ReadbackQueue::Capture(const Framebuffer& framebuffer)
+{
+	uint64_t index = m_NextIndex++;
+
+	/* Make room if the oldest capture has landed since the last Update */
+	if (m_InFlight == m_Slots.size())
+		Retire(0);
+	if (m_InFlight == m_Slots.size())
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stats.Dropped++;
+		return false;
+	}
+
+	Slot& slot = m_Slots[(m_Oldest + m_InFlight) % m_Slots.size()];
+	slot.Index = index;
+	slot.Width = framebuffer.GetWidth();
+	slot.Height = framebuffer.GetHeight();
+
+	size_t size = (size_t)slot.Width * slot.Height * 4;
+	if (size > slot.Capacity)
+	{
+		GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.PixelBuffer));
+		GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ));
+		GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+		slot.Capacity = size;
+	}
+
+	framebuffer.ReadPixelsInto(slot.PixelBuffer);
+	GLCall(slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	m_InFlight++;
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Stats.Captured++;
+	return true;
+}
+
+void ReadbackQueue::Update()
+{
+	Retire(0);
+}
+
+void ReadbackQueue::Flush()
+{
+	/* A second per wait, a GPU that takes longer than that has bigger problems */
+	while (m_InFlight > 0)
+		Retire(1000000000);
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Idle.wait(lock, [this] { return m_Queued.empty() && !m_Busy; });
+}
+
+ReadbackQueue::Stats ReadbackQueue::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Stats;
+}
+
+void ReadbackQueue::Retire(GLuint64 timeout)
+{
+	CPU_PROFILE_SCOPE("ReadbackQueue::Retire");
+	while (m_InFlight > 0)
+	{
+		Slot& slot = m_Slots[m_Oldest];
+
+		/* Later slots were fenced later, so the first one still busy ends the search */
+		GLenum result;
+		GLCall(result = glClientWaitSync(slot.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout));
+		if (result == GL_TIMEOUT_EXPIRED)
+			return;
+
+		GLCall(glDeleteSync(slot.Fence));
+		slot.Fence = nullptr;
+		m_Oldest = (m_Oldest + 1) % m_Slots.size();
+		m_InFlight--;
+
+		Frame frame;
+		frame.Index = slot.Index;
+		frame.Width = slot.Width;
+		frame.Height = slot.Height;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (result == GL_WAIT_FAILED || m_Queued.size() >= m_MaxQueued)
+			{
+				m_Stats.Dropped++;
+				continue;
+			}
+			if (!m_FreePixels.empty())
+			{
+				frame.Pixels.swap(m_FreePixels.back());
+				m_FreePixels.pop_back();
+			}
+		}
+
+		size_t size = (size_t)slot.Width * slot.Height * 4;
+		frame.Pixels.resize(size);
+		GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.PixelBuffer));
+		const void* mapped;
+		GLCall(mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+		if (mapped)
+			memcpy(frame.Pixels.data(), mapped, size);
+		GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+		GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (mapped)
+				m_Queued.push_back(std::move(frame));
+			else
+				m_Stats.Dropped++;
+		}
+		m_Wake.notify_one();
+	}
+}
+
+void ReadbackQueue::Run()
+{
+	CpuProfiler::SetThreadName("Readback");
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (true)
+	{
+		m_Wake.wait(lock, [this] { return !m_Queued.empty() || !m_Running; });
+		if (m_Queued.empty())
+			return;
+
+		Frame frame = std::move(m_Queued.front());
+		m_Queued.pop_front();
+		m_Busy = true;
+
+		lock.unlock();
+		if (m_Callback)
+		{
+			CPU_PROFILE_SCOPE("ReadbackQueue callback");
+			m_Callback(frame);
+		}
+		lock.lock();
+
+		m_Busy = false;
+		m_Stats.Delivered++;
+		m_FreePixels.push_back(std::move(frame.Pixels));
+		m_Idle.notify_all();
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Framebuffer;
+
+/* Captures Framebuffer contents without stalling. Each Capture reads into the next of a ring
+   of pixel pack buffers and fences it; Update polls the fences without waiting, copies out
+   the finished ones in order and hands them to a worker thread, where the callback can do
+   slow things like encoding PNGs. Captures are dropped, not waited for, when the ring or
+   the worker falls behind */
+class ReadbackQueue
+{
+public:
+	struct Frame
+	{
+		uint64_t Index;			// counts every Capture, dropped ones included
+		int Width, Height;
+		std::vector<unsigned char> Pixels;	// RGBA8, bottom row first
+	};
+
+	/* Runs on the worker thread, one frame at a time in capture order */
+	using Callback = std::function<void(const Frame&)>;
+
+	struct Stats
+	{
+		unsigned int Captured;
+		unsigned int Delivered;
+		unsigned int Dropped;
+	};
+
+private:
+	struct Slot
+	{
+		unsigned int PixelBuffer;
+		size_t Capacity;
+		GLsync Fence;
+		uint64_t Index;
+		int Width, Height;
+	};
+
+	/* In flight slots are m_Oldest onwards, in the order they were captured */
+	std::vector<Slot> m_Slots;
+	unsigned int m_Oldest, m_InFlight;
+	uint64_t m_NextIndex;
+	/* Frames waiting for the worker before new ones are dropped */
+	size_t m_MaxQueued;
+	Callback m_Callback;
+
+	std::thread m_Worker;
+	std::mutex m_Mutex;
+	std::condition_variable m_Wake, m_Idle;
+	std::deque<Frame> m_Queued;
+	/* Pixel storage handed back by the worker, so steady capture doesn't allocate */
+	std::vector<std::vector<unsigned char>> m_FreePixels;
+	bool m_Running, m_Busy;
+	Stats m_Stats;
+
+public:
+	ReadbackQueue(unsigned int slotCount, Callback callback);
+	/* Delivers everything already captured before returning */
+	~ReadbackQueue();
+
+	ReadbackQueue(const ReadbackQueue&) = delete;
+	ReadbackQueue& operator=(const ReadbackQueue&) = delete;
+
+	/* Queue a copy of the framebuffer's resolved colour, false if it had to be dropped */
+	bool Capture(const Framebuffer& framebuffer);
+
+	/* Call once a frame, hands every finished capture to the worker */
+	void Update();
+
+	/* Wait for the GPU and the worker to finish everything captured so far */
+	void Flush();
+
+	Stats GetStats();
+
+private:
+	/* Copy out finished slots from the oldest on, waiting at most timeout for each */
+	void Retire(GLuint64 timeout);
+	void Run();
+};
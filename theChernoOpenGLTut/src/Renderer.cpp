@@ -1,17 +1,98 @@
 #include "Renderer.h"
 
+#include "UniformBuffer.h"
+
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Set once the debug callback is installed, GLCall then stops polling glGetError */
+static bool s_DebugOutput = false;
+
+struct GLDebugMessage
+{
+	GLenum type;
+	std::string message;
+};
+
+/* Messages raised during the current GLCall, reported by GLLogCall with its call site */
+static std::vector<GLDebugMessage> s_PendingMessages;
+/* Between GLBeginIgnoreErrors and GLEndIgnoreErrors */
+static bool s_IgnoreErrors = false;
+
+static void GLAPIENTRY GLDebugCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+	GLsizei length, const GLchar* message, const void* userParam)
+{
+	if (s_IgnoreErrors)
+		return;
+
+#if GLCALL_CHECKS
+	s_PendingMessages.push_back({ type, std::string(message, length) });
+#else
+	/* Without GLCall bookkeeping there is no call site to wait for */
+	std::cout << (type == GL_DEBUG_TYPE_ERROR ? "[OpenGL Error] " : "[OpenGL Debug] ")
+		<< std::string(message, length) << std::endl;
+#endif
+}
+
+static void PrintDebugMessages(const char* function, const char* file, int line)
+{
+	for (const auto& pending : s_PendingMessages)
+	{
+		std::cout << (pending.type == GL_DEBUG_TYPE_ERROR ? "[OpenGL Error] " : "[OpenGL Debug] ")
+			<< pending.message;
+		if (function)
+			std::cout << " " << function << " " << file << ":" << line;
+		std::cout << std::endl;
+	}
+}
 
 void GLClearError()
 {
+	if (s_DebugOutput)
+	{
+		/* Anything left over was raised outside of a GLCall (e.g. by ImGui) */
+		PrintDebugMessages(nullptr, nullptr, 0);
+		s_PendingMessages.clear();
+		return;
+	}
+
 	while (glGetError() != GL_NO_ERROR);
 }
 
+void GLBeginIgnoreErrors()
+{
+	/* Whatever came before still gets reported */
+	GLClearError();
+	s_IgnoreErrors = true;
+}
+
+void GLEndIgnoreErrors()
+{
+	s_PendingMessages.clear();
+	while (glGetError() != GL_NO_ERROR);
+	s_IgnoreErrors = false;
+}
+
 /* Print Error Messages to the console */
 // To refference error numbers,
 // you will have to convert to hexadecimal
 bool GLLogCall(const char* function, const char* file, int line)
 {
+	if (s_DebugOutput)
+	{
+		bool ok = true;
+		for (const auto& pending : s_PendingMessages)
+		{
+			if (pending.type == GL_DEBUG_TYPE_ERROR)
+				ok = false;
+		}
+		PrintDebugMessages(function, file, line);
+		s_PendingMessages.clear();
+		return ok;
+	}
+
 	while (GLenum error = glGetError())
 	{
 		std::cout << "[OpenGL Error] (" << error << "): "
@@ -23,15 +104,121 @@ bool GLLogCall(const char* function, const char* file, int line)
 	return true;
 }
 
+bool GLEnableDebugOutput()
+{
+	if (!GLEW_VERSION_4_3 && !GLEW_KHR_debug)
+		return false;
+
+	/* Synchronous output fires the callback inside the offending call,
+	   so GLLogCall can attach the file and line it was made from */
+	glEnable(GL_DEBUG_OUTPUT);
+	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	glDebugMessageCallback(GLDebugCallback, nullptr);
+	glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+
+	/* Drop anything queued before the callback took over */
+	while (glGetError() != GL_NO_ERROR);
+	s_DebugOutput = true;
+	return true;
+}
+
+/* Offsets of the Camera block members, in the order the shaders declare them */
+struct CameraBlock
+{
+	unsigned int Proj, View, ViewProj, Time, Resolution;
+};
+
+static CameraBlock s_CameraBlock;
+static std::unique_ptr<UniformBuffer> s_CameraBuffer;
+
+static Renderer::Stats s_Stats = { 0, 0 };
+
+void Renderer::Init()
+{
+	UniformBufferLayout layout;
+	s_CameraBlock.Proj = layout.Push<glm::mat4>();
+	s_CameraBlock.View = layout.Push<glm::mat4>();
+	s_CameraBlock.ViewProj = layout.Push<glm::mat4>();
+	s_CameraBlock.Time = layout.Push<float>();
+	s_CameraBlock.Resolution = layout.Push<glm::vec2>();
+
+	s_CameraBuffer = std::make_unique<UniformBuffer>(layout, UniformBuffer::CameraBinding);
+	SetCamera(glm::mat4(1.0f), glm::mat4(1.0f));
+}
+
+void Renderer::Shutdown()
+{
+	s_CameraBuffer.reset();
+}
+
+void Renderer::BeginFrame(float time, const glm::vec2& resolution)
+{
+	s_CameraBuffer->Set(s_CameraBlock.Time, time);
+	s_CameraBuffer->Set(s_CameraBlock.Resolution, resolution);
+}
+
+void Renderer::SetCamera(const glm::mat4& proj, const glm::mat4& view)
+{
+	s_CameraBuffer->Set(s_CameraBlock.Proj, proj);
+	s_CameraBuffer->Set(s_CameraBlock.View, view);
+	s_CameraBuffer->Set(s_CameraBlock.ViewProj, proj * view);
+}
+
+void Renderer::UploadCamera()
+{
+	if (s_CameraBuffer)
+		s_CameraBuffer->Upload();
+}
+
 void Renderer::Clear() const
 {
-	GLCall(glClear(GL_COLOR_BUFFER_BIT));
+	/* Stencil too, Framebuffer depth attachments are always depth/stencil */
+	GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
 }
 
 void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader)
 {
+	UploadCamera();
 	shader.Bind();
 	va.Bind();
 	ib.Bind();
 	GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
+	s_Stats.DrawCalls++;
+	s_Stats.Triangles += ib.GetCount() / 3;
+}
+
+/* Draw only the first indexCount indices, used when a buffer is partially filled.
+   baseVertex is added to every index, for geometry written further into a streaming buffer */
+void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int indexCount, int baseVertex)
+{
+	UploadCamera();
+	shader.Bind();
+	va.Bind();
+	ib.Bind();
+	GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr, baseVertex));
+	s_Stats.DrawCalls++;
+	s_Stats.Triangles += indexCount / 3;
+}
+
+/* Draw the whole index buffer instanceCount times, per-instance data comes from
+   attributes with a divisor (see VertexBufferLayout) */
+void Renderer::DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount)
+{
+	UploadCamera();
+	shader.Bind();
+	va.Bind();
+	ib.Bind();
+	GLCall(glDrawElementsInstanced(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr, instanceCount));
+	s_Stats.DrawCalls++;
+	s_Stats.Triangles += ib.GetCount() / 3 * instanceCount;
+}
+
+const Renderer::Stats& Renderer::GetStats()
+{
+	return s_Stats;
+}
+
+void Renderer::ResetStats()
+{
+	s_Stats = { 0, 0 };
 }
@@ -6,10 +6,32 @@
 #include "IndexBuffer.h"
 #include "Shader.h"
 
-#define ASSERT(x) if (!(x)) __debugbreak();
+#include "glm/glm.hpp"
+
+#if defined(_MSC_VER)
+	#define DEBUG_BREAK() __debugbreak()
+#else
+	#include <signal.h>
+	#define DEBUG_BREAK() raise(SIGTRAP)
+#endif
+
+#define ASSERT(x) if (!(x)) DEBUG_BREAK();
+
+/* Release builds (NDEBUG) compile GLCall down to the bare call,
+   define GL_FORCE_CHECKS to keep the error checks there */
+#if defined(NDEBUG) && !defined(GL_FORCE_CHECKS)
+	#define GLCALL_CHECKS 0
+#else
+	#define GLCALL_CHECKS 1
+#endif
+
+#if !GLCALL_CHECKS
+#define GLCall(x) x
+#else
 #define GLCall(x) GLClearError();\
 	x;\
 	ASSERT(GLLogCall(#x, __FILE__, __LINE__))
+#endif
 
 /* Call all Error Messages out of the Error Stack */
 void GLClearError();
@@ -19,9 +41,42 @@ void GLClearError();
 // you will have to convert to hexadecimal
 bool GLLogCall(const char* function, const char* file, int line);
 
+/* Around calls that are expected to fail sometimes, e.g. glProgramBinary with a binary the
+   driver no longer takes: errors and debug messages raised in between are dropped unprinted */
+void GLBeginIgnoreErrors();
+void GLEndIgnoreErrors();
+
+/* Report errors through a synchronous KHR_debug callback instead of glGetError.
+   Needs GL 4.3 or GL_KHR_debug, returns false when neither is available */
+bool GLEnableDebugOutput();
+
 class Renderer
 {
 public:
+	/* Work submitted through Draw/DrawInstanced since the last ResetStats */
+	struct Stats
+	{
+		unsigned int DrawCalls;
+		unsigned int Triangles;
+	};
+
+
+	/* Create and release the shared Camera uniform block, both need a current context */
+	static void Init();
+	static void Shutdown();
+
+	/* Per-frame members of the Camera block, uploaded once before the next draw */
+	static void BeginFrame(float time, const glm::vec2& resolution);
+	static void SetCamera(const glm::mat4& proj, const glm::mat4& view);
+
 	void Clear() const;
 	void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader);
+	void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int indexCount, int baseVertex = 0);
+	void DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount);
+
+	static const Stats& GetStats();
+	static void ResetStats();
+
+private:
+	static void UploadCamera();
 };
\ No newline at end of file
@@ -1,90 +1,331 @@
 #include "Shader.h"
 
 #include "Renderer.h"
+#include "StateCache.h"
+#include "Hash.h"
+#include "UniformBuffer.h"
+#include "AssetWatcher.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <string>
 #include <sstream>
+#include <vector>
 
-Shader::Shader(const std::string& filepath)
-	: m_FilePath(filepath), m_RendererID(0)
+const char* Shader::s_ProgramCacheDirectory = "cache/shaders";
+bool Shader::s_ProgramCacheEnabled = true;
+Shader::CacheStats Shader::s_CacheStats = { 0, 0 };
+
+/* glGetProgramBinary needs GL 4.1 or ARB_get_program_binary, and at least one binary format */
+static bool ProgramBinarySupported()
+{
+	static int supported = -1;
+	if (supported == -1)
+	{
+		int formats = 0;
+		if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+		{
+			GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+		}
+		supported = formats > 0;
+	}
+	return supported == 1;
+}
+
+/* GLSL types a handle of type T can be set on */
+template<typename T> static bool UniformTypeMatches(unsigned int type);
+
+template<> bool UniformTypeMatches<int>(unsigned int type)
+{
+	switch (type)
+	{
+	case GL_INT: case GL_BOOL:
+	case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+	case GL_SAMPLER_2D_ARRAY: case GL_SAMPLER_2D_MULTISAMPLE: case GL_SAMPLER_2D_SHADOW:
+		return true;
+	}
+	return false;
+}
+template<> bool UniformTypeMatches<float>(unsigned int type) { return type == GL_FLOAT; }
+template<> bool UniformTypeMatches<glm::vec2>(unsigned int type) { return type == GL_FLOAT_VEC2; }
+template<> bool UniformTypeMatches<glm::vec4>(unsigned int type) { return type == GL_FLOAT_VEC4; }
+template<> bool UniformTypeMatches<glm::mat4>(unsigned int type) { return type == GL_FLOAT_MAT4; }
+
+Shader::Shader(const std::string& filepath, const ShaderDefines& defines)
+	: Shader(filepath, ShaderPreprocessor::ProcessFile(filepath, defines), false)
+{
+}
+
+Shader::Shader(const std::string& name, std::string_view source, const ShaderDefines& defines,
+	const ShaderIncludeResolver& resolver)
+	: Shader(name, ShaderPreprocessor::Process(source, name, defines, resolver), false)
+{
+}
+
+Shader::Shader(const std::string& filepath, const ShaderProgramSource& source, bool deferred)
+	: m_FilePath(filepath), m_RendererID(0), m_Key(source.Key), m_Linked(false),
+	m_Defines(source.Defines), m_Includes(source.Includes), m_Generation(0),
+	m_PendingStages{}, m_Pending(false)
+{
+	Build(source, deferred);
+	AssetWatcher::OnShaderCreated(this);
+}
+
+void Shader::Build(const ShaderProgramSource& source, bool deferred)
+{
+	/* Only pay for compiling and linking when there's no usable binary on disk */
+	if (s_ProgramCacheEnabled && ProgramBinarySupported())
+	{
+		m_CachePath = GetProgramCachePath(source);
+		m_RendererID = LoadProgramBinary(m_CachePath);
+		if (m_RendererID != 0)
+		{
+			m_Linked = true;
+			BindUniformBlocks();
+			ReflectUniforms();
+		}
+	}
+
+	if (m_RendererID == 0)
+	{
+		m_RendererID = CreateShader(source);
+		if (!deferred)
+			FinishCreate();
+	}
+}
+
+/* Compile next to the current program and only swap once the new one has linked */
+bool Shader::Rebuild(const ShaderProgramSource& source)
+{
+	/* A deferred compile still in flight would have its stages overwritten, finish it first */
+	if (m_Pending)
+		FinishCreate();
+
+	unsigned int previous = m_RendererID;
+	bool previousLinked = m_Linked;
+	std::unordered_map<uint64_t, UniformInfo> previousUniforms = std::move(m_Uniforms);
+	std::string previousCachePath = std::move(m_CachePath);
+
+	m_RendererID = 0;
+	m_Uniforms.clear();
+	m_CachePath.clear();
+	m_Linked = false;
+	Build(source, false);
+
+	if (!m_Linked)
+	{
+		std::cout << "Warning: keeping the previous program of " << m_FilePath << std::endl;
+		GLCall(glDeleteProgram(m_RendererID));
+		m_RendererID = previous;
+		m_Uniforms = std::move(previousUniforms);
+		m_CachePath = std::move(previousCachePath);
+		m_Linked = previousLinked;
+		return false;
+	}
+
+	CopyUniformValues(previous, previousUniforms);
+	GLCall(glDeleteProgram(previous));
+	StateCache::Get().OnProgramDeleted(previous);
+
+	m_Key = source.Key;
+	m_Includes = source.Includes;
+	m_Generation++;
+	return true;
+}
+
+bool Shader::Reload()
+{
+	return Rebuild(ShaderPreprocessor::ProcessFile(m_FilePath, m_Defines));
+}
+
+bool Shader::Reload(std::string_view source)
+{
+	return Rebuild(ShaderPreprocessor::Process(source, m_FilePath, m_Defines));
+}
+
+bool Shader::DependsOn(const std::string& path) const
 {
-	ShaderProgramSource source = ParseShader(filepath);
-	m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+	std::string normalised = std::filesystem::path(path).lexically_normal().generic_string();
+	if (std::filesystem::path(m_FilePath).lexically_normal().generic_string() == normalised)
+		return true;
+	return std::find(m_Includes.begin(), m_Includes.end(), normalised) != m_Includes.end();
+}
+
+/* Give the new program the values the old one had, so state set once at startup survives a reload */
+void Shader::CopyUniformValues(unsigned int fromProgram, const std::unordered_map<uint64_t, UniformInfo>& fromUniforms)
+{
+	StateCache::Get().UseProgram(m_RendererID);
+
+	int count = 0, maxLength = 0;
+	GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count));
+	GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+
+	std::vector<char> name(maxLength + 1);
+	for (int i = 0; i < count; i++)
+	{
+		int length = 0, size = 0;
+		GLenum type = 0;
+		GLCall(glGetActiveUniform(m_RendererID, i, (GLsizei)name.size(), &length, &size, &type, name.data()));
+
+		/* Only copy when the old program declared it with the same type */
+		std::string base(name.data(), length);
+		if (base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0)
+			base.resize(base.size() - 3);
+		auto previous = fromUniforms.find(HashBytes(base.data(), base.size()));
+		if (previous == fromUniforms.end() || previous->second.Type != type)
+			continue;
+
+		for (int element = 0; element < size; element++)
+		{
+			std::string elementName = size > 1 ? base + "[" + std::to_string(element) + "]" : base;
+			GLCall(int from = glGetUniformLocation(fromProgram, elementName.c_str()));
+			GLCall(int to = glGetUniformLocation(m_RendererID, elementName.c_str()));
+			if (from == -1 || to == -1)
+				continue;
+
+			float f[16];
+			int n;
+			switch (type)
+			{
+			case GL_FLOAT:		GLCall(glGetUniformfv(fromProgram, from, f)); GLCall(glUniform1fv(to, 1, f)); break;
+			case GL_FLOAT_VEC2:	GLCall(glGetUniformfv(fromProgram, from, f)); GLCall(glUniform2fv(to, 1, f)); break;
+			case GL_FLOAT_VEC3:	GLCall(glGetUniformfv(fromProgram, from, f)); GLCall(glUniform3fv(to, 1, f)); break;
+			case GL_FLOAT_VEC4:	GLCall(glGetUniformfv(fromProgram, from, f)); GLCall(glUniform4fv(to, 1, f)); break;
+			case GL_FLOAT_MAT3:	GLCall(glGetUniformfv(fromProgram, from, f)); GLCall(glUniformMatrix3fv(to, 1, GL_FALSE, f)); break;
+			case GL_FLOAT_MAT4:	GLCall(glGetUniformfv(fromProgram, from, f)); GLCall(glUniformMatrix4fv(to, 1, GL_FALSE, f)); break;
+			default:
+				if (UniformTypeMatches<int>(type))
+				{
+					GLCall(glGetUniformiv(fromProgram, from, &n));
+					GLCall(glUniform1i(to, n));
+				}
+				break;
+			}
+		}
+	}
 }
 
 Shader::~Shader()
 {
+	AssetWatcher::OnShaderDeleted(this);
+	if (m_Pending)
+	{
+		for (unsigned int id : m_PendingStages)
+		{
+			if (id != 0)
+			{
+				GLCall(glDeleteShader(id));
+			}
+		}
+	}
 	GLCall(glDeleteProgram(m_RendererID));
+	StateCache::Get().OnProgramDeleted(m_RendererID);
 }
 
 void Shader::Bind() const
 {
-	GLCall(glUseProgram(m_RendererID));
+	StateCache::Get().UseProgram(m_RendererID);
 }
 
 void Shader::Unbind() const
 {
-	GLCall(glUseProgram(0));
+	StateCache::Get().UseProgram(0);
 }
 
-void Shader::SetUniform1i(const std::string name, int value)
+void Shader::SetUniform1i(const std::string& name, int value)
 {
 	GLCall(glUniform1i(GetUniformLocation(name), value));
 }
 
-void Shader::SetUniform4f(const std::string name, float v0, float v1, float v2, float v3)
+void Shader::SetUniform1iv(const std::string& name, int count, const int* values)
+{
+	GLCall(glUniform1iv(GetUniformLocation(name), count, values));
+}
+
+void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3)
 {
 	GLCall(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3));
 }
 
-void Shader::SetUniformMat4f(const std::string name, const glm::mat4& matrix)
+void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
 {
 	GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
 }
 
-ShaderProgramSource Shader::ParseShader(const std::string& filepath)
+template<typename T>
+UniformHandle<T> Shader::GetUniform(uint64_t nameHash) const
 {
-	/* Create in-stream object */
-	std::ifstream stream(filepath);
-
-	/* Specify Function Modes */
-	enum class ShaderType
+	auto it = m_Uniforms.find(nameHash);
+	if (it == m_Uniforms.end() || it->second.Location == -1)
 	{
-		NONE = -1,
-		VERTEX = 0,
-		FRAGMENT = 1,
-	};
-	ShaderType type = ShaderType::NONE; //initialize function mode
-
-	/* Allocate Data */
-	std::string line;
-	std::stringstream ss[2];
-
-	/* Read File */
-	while (getline(stream, line))
+		std::cout << "Warning: Uniform (hash " << std::hex << nameHash << std::dec << ") does not exist in " << m_FilePath << "!" << std::endl;
+		return UniformHandle<T>();
+	}
+	if (!UniformTypeMatches<T>(it->second.Type))
 	{
-		if (line.find("#shader") != std::string::npos)
-		{
-			if (line.find("vertex") != std::string::npos)
-				type = ShaderType::VERTEX;
-			else if (line.find("fragment") != std::string::npos)
-				type = ShaderType::FRAGMENT;
-		}
-		else
-		{
-			ss[(int)type] << line << '\n';
-		}
+		std::cout << "Warning: Uniform (hash " << std::hex << nameHash << std::dec << ") in " << m_FilePath << " has a different type!" << std::endl;
+		return UniformHandle<T>();
 	}
+	return UniformHandle<T>(it->second.Location, nameHash, m_Generation);
+}
+
+template<typename T>
+int Shader::GetUniformLocation(UniformHandle<T> uniform) const
+{
+	if (uniform.GetGeneration() == m_Generation)
+		return uniform.GetLocation();
+
+	/* Made before a reload, the table was rebuilt along with the program */
+	auto it = m_Uniforms.find(uniform.GetNameHash());
+	return it != m_Uniforms.end() ? it->second.Location : -1;
+}
+
+template UniformHandle<int> Shader::GetUniform<int>(uint64_t nameHash) const;
+template UniformHandle<float> Shader::GetUniform<float>(uint64_t nameHash) const;
+template UniformHandle<glm::vec2> Shader::GetUniform<glm::vec2>(uint64_t nameHash) const;
+template UniformHandle<glm::vec4> Shader::GetUniform<glm::vec4>(uint64_t nameHash) const;
+template UniformHandle<glm::mat4> Shader::GetUniform<glm::mat4>(uint64_t nameHash) const;
+
+void Shader::SetUniform(UniformHandle<int> uniform, int value)
+{
+	GLCall(glUniform1i(GetUniformLocation(uniform), value));
+}
 
-	return { ss[0].str(), ss[1].str() };
+void Shader::SetUniform(UniformHandle<float> uniform, float value)
+{
+	GLCall(glUniform1f(GetUniformLocation(uniform), value));
+}
+
+void Shader::SetUniform(UniformHandle<glm::vec2> uniform, const glm::vec2& value)
+{
+	GLCall(glUniform2f(GetUniformLocation(uniform), value.x, value.y));
+}
+
+void Shader::SetUniform(UniformHandle<glm::vec4> uniform, const glm::vec4& value)
+{
+	GLCall(glUniform4f(GetUniformLocation(uniform), value.x, value.y, value.z, value.w));
+}
+
+void Shader::SetUniform(UniformHandle<glm::mat4> uniform, const glm::mat4& value)
+{
+	GLCall(glUniformMatrix4fv(GetUniformLocation(uniform), 1, GL_FALSE, &value[0][0]));
 }
 
-unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
+/* GL enum of each ShaderStage */
+static const unsigned int s_StageTypes[(int)ShaderStage::Count] =
+{
+	GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER,
+	GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER, GL_COMPUTE_SHADER,
+};
+
+unsigned int Shader::CompileShader(ShaderStage stage, const std::string& source)
 {
 	/* Create id for shader storage */
-	GLCall(unsigned int id = glCreateShader(type));
+	GLCall(unsigned int id = glCreateShader(s_StageTypes[(int)stage]));
 
 	/* Obtain pure string location */
 	const char* src = source.c_str();
@@ -92,9 +333,15 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 	/* load source code into OpenGL */
 	GLCall(glShaderSource(id, 1, &src, nullptr));
 
-	/* Compile Shader */
+	/* Compile Shader, errors are checked in FinishCreate so the driver can work in the background */
 	GLCall(glCompileShader(id));
 
+	/* Return index for future use */
+	return id;
+}
+
+bool Shader::CheckCompileStatus(unsigned int id, ShaderStage stage)
+{
 	/* Check for Compiler Errors */
 	int result;
 	GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
@@ -110,51 +357,268 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 
 		/* Print Error */
 		std::cout << "failed to compile "
-			<< (type == GL_VERTEX_SHADER ? "vertex" : "fragment")
-			<< " shader!" << std::endl;
+			<< GetShaderStageName(stage)
+			<< " shader of " << m_FilePath << "!" << std::endl;
 		std::cout << message << std::endl;
-		GLCall(glDeleteShader(id));
-		return 0;
+		return false;
 	}
-
-	/* Return index for future use */
-	return id;
+	return true;
 }
 
-unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
+unsigned int Shader::CreateShader(const ShaderProgramSource& source)
 {
-	/* Create ids for shader components */
-	GLCall(unsigned int program = glCreateProgram());								//Final Shader Program
-	GLCall(unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader));		//vertex Shader
-	GLCall(unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader));	//fragment Shader
+	/* Create id for the final program */
+	GLCall(unsigned int program = glCreateProgram());
 
-	/* Associate Shaders with program */
-	GLCall(glAttachShader(program, vs));
-	GLCall(glAttachShader(program, fs));
+	/* Compile and attach every stage the file has */
+	for (int i = 0; i < (int)ShaderStage::Count; i++)
+	{
+		ShaderStage stage = (ShaderStage)i;
+		if (!source.Has(stage))
+			continue;
+		if (!IsStageSupported(stage))
+		{
+			std::cout << "Warning: " << GetShaderStageName(stage) << " shaders are not supported, skipped in " << m_FilePath << std::endl;
+			continue;
+		}
 
-	/* Link Shaders together */
+		m_PendingStages[i] = CompileShader(stage, source.Get(stage));
+		GLCall(glAttachShader(program, m_PendingStages[i]));
+	}
+
+	/* Ask the driver to keep the binary around for the program cache */
+	if (s_ProgramCacheEnabled && ProgramBinarySupported())
+	{
+		GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+	}
+
+	/* Link Shaders together, querying the result would block until the link is done */
 	GLCall(glLinkProgram(program));
+	m_Pending = true;
+
+	/* return program id */
+	return program;
+}
 
-	/* Validate Program */
-	GLCall(glValidateProgram(program));
+bool Shader::FinishCreate()
+{
+	bool compiled = true;
+	for (int i = 0; i < (int)ShaderStage::Count; i++)
+	{
+		if (m_PendingStages[i] != 0)
+			compiled = CheckCompileStatus(m_PendingStages[i], (ShaderStage)i) && compiled;
+	}
+
+	/* Check for Linker Errors */
+	int linked;
+	GLCall(glGetProgramiv(m_RendererID, GL_LINK_STATUS, &linked));
+	if (compiled && linked == GL_FALSE)
+	{
+		int length;
+		GLCall(glGetProgramiv(m_RendererID, GL_INFO_LOG_LENGTH, &length));
+		std::vector<char> message(length + 1);
+		GLCall(glGetProgramInfoLog(m_RendererID, length, &length, message.data()));
+		std::cout << "failed to link " << m_FilePath << "!" << std::endl;
+		std::cout << message.data() << std::endl;
+	}
+
+#ifndef NDEBUG
+	/* Validate Program, expensive and only meaningful while debugging */
+	GLCall(glValidateProgram(m_RendererID));
+#endif
 
 	/* Clear Temporary files */
-	GLCall(glDeleteShader(vs));
-	GLCall(glDeleteShader(fs));
+	for (unsigned int& id : m_PendingStages)
+	{
+		if (id != 0)
+		{
+			GLCall(glDeleteShader(id));
+		}
+		id = 0;
+	}
+	m_Pending = false;
 
-	/* return program id */
+	m_Linked = linked == GL_TRUE;
+	if (m_Linked)
+	{
+		BindUniformBlocks();
+		ReflectUniforms();
+		if (!m_CachePath.empty())
+			SaveProgramBinary(m_RendererID, m_CachePath);
+	}
+	return m_Linked;
+}
+
+/* Point the shared blocks at their fixed binding points, so shaders only have to declare them */
+void Shader::BindUniformBlocks()
+{
+	GLCall(unsigned int camera = glGetUniformBlockIndex(m_RendererID, "Camera"));
+	if (camera != GL_INVALID_INDEX)
+	{
+		GLCall(glUniformBlockBinding(m_RendererID, camera, UniformBuffer::CameraBinding));
+	}
+}
+
+/* Build the uniform table once, so neither path has to ask GL for locations later */
+void Shader::ReflectUniforms()
+{
+	m_Uniforms.clear();
+
+	int count = 0, maxLength = 0;
+	GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count));
+	GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+
+	std::vector<char> name(maxLength + 1);
+	for (int i = 0; i < count; i++)
+	{
+		int length = 0, size = 0;
+		GLenum type = 0;
+		GLCall(glGetActiveUniform(m_RendererID, i, (GLsizei)name.size(), &length, &size, &type, name.data()));
+
+		/* Members of uniform blocks have no location and are skipped */
+		GLCall(int location = glGetUniformLocation(m_RendererID, name.data()));
+		if (location == -1)
+			continue;
+
+		/* Arrays are reported as their first element */
+		if (length > 3 && strcmp(name.data() + length - 3, "[0]") == 0)
+			length -= 3;
+
+		m_Uniforms[HashBytes(name.data(), length)] = { location, type };
+	}
+}
+
+/* Finish a deferred compile if the driver is done with it, returns true once ready */
+bool Shader::PollCompile()
+{
+	if (!m_Pending)
+		return true;
+
+	/* Without the extension there is nothing to poll, the status query just blocks */
+	if (IsParallelCompileSupported())
+	{
+		int complete = GL_FALSE;
+		GLCall(glGetProgramiv(m_RendererID, GL_COMPLETION_STATUS_KHR, &complete));
+		if (complete == GL_FALSE)
+			return false;
+	}
+
+	FinishCreate();
+	return true;
+}
+
+bool Shader::IsParallelCompileSupported()
+{
+	return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+}
+
+/* Vertex, fragment and geometry are all core in 3.3 */
+bool Shader::IsStageSupported(ShaderStage stage)
+{
+	switch (stage)
+	{
+	case ShaderStage::TessControl: case ShaderStage::TessEvaluation:
+		return GLEW_VERSION_4_0 || GLEW_ARB_tessellation_shader;
+	case ShaderStage::Compute:
+		return GLEW_VERSION_4_3 || GLEW_ARB_compute_shader;
+	default:
+		return stage < ShaderStage::Count;
+	}
+}
+
+std::string Shader::GetProgramCachePath(const ShaderProgramSource& source)
+{
+	/* A binary is only valid for the exact driver that produced it */
+	const char* strings[] =
+	{
+		(const char*)glGetString(GL_VENDOR),
+		(const char*)glGetString(GL_RENDERER),
+		(const char*)glGetString(GL_VERSION),
+	};
+
+	uint64_t hash = source.Key;
+	for (const char* str : strings)
+	{
+		if (str)
+			hash = HashBytes(str, strlen(str), hash);
+	}
+
+	std::stringstream ss;
+	ss << s_ProgramCacheDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+	return ss.str();
+}
+
+unsigned int Shader::LoadProgramBinary(const std::string& cachePath)
+{
+	std::ifstream stream(cachePath, std::ios::binary);
+	if (!stream)
+	{
+		s_CacheStats.Misses++;
+		return 0;
+	}
+
+	/* File layout: the GLenum binary format followed by the binary itself */
+	GLenum format = 0;
+	stream.read((char*)&format, sizeof(format));
+	std::vector<char> binary((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	GLCall(unsigned int program = glCreateProgram());
+
+	/* A driver update can reject an old binary with a GL error, e.g. GL_INVALID_ENUM for
+	   a format it no longer supports. That only means a rebuild, so it isn't reported */
+	GLBeginIgnoreErrors();
+	glProgramBinary(program, format, binary.data(), (GLsizei)binary.size());
+	GLEndIgnoreErrors();
+
+	int linked = GL_FALSE;
+	GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+	if (linked == GL_FALSE)
+	{
+		GLCall(glDeleteProgram(program));
+		s_CacheStats.Misses++;
+		return 0;
+	}
+
+	s_CacheStats.Hits++;
 	return program;
 }
 
+void Shader::SaveProgramBinary(unsigned int program, const std::string& cachePath)
+{
+	int length = 0;
+	GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+	if (length <= 0)
+		return;
+
+	std::vector<char> binary(length);
+	GLenum format = 0;
+	GLCall(glGetProgramBinary(program, length, &length, &format, binary.data()));
+
+	std::error_code error;
+	std::filesystem::create_directories(s_ProgramCacheDirectory, error);
+
+	std::ofstream stream(cachePath, std::ios::binary);
+	if (!stream)
+	{
+		std::cout << "Warning: could not write program cache '" << cachePath << "'" << std::endl;
+		return;
+	}
+	stream.write((const char*)&format, sizeof(format));
+	stream.write(binary.data(), length);
+}
+
 int Shader::GetUniformLocation(const std::string& name)
 {
-	if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
-		return m_UniformLocationCache[name];
+	uint64_t hash = HashBytes(name.data(), name.size());
+	auto it = m_Uniforms.find(hash);
+	if (it != m_Uniforms.end())
+		return it->second.Location;
 
+	/* Not in the reflected table, e.g. a single array element like u_Textures[3] */
 	GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
 	if (location == -1)
 		std::cout << "Warning: Uniform '" << name << " does not exist!" << std::endl;
 
-	m_UniformLocationCache[name] = location;
+	m_Uniforms[hash] = { location, 0 };
 	return location;
 }
@@ -1,39 +1,156 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include "glm/glm.hpp"
 
-struct ShaderProgramSource
+#include "Hash.h"
+#include "ShaderPreprocessor.h"
+
+/* A uniform location resolved once through Shader::GetUniform, T selects the
+   glUniform call so setting it needs no string work. Invalid (-1) handles are ignored by GL.
+   A handle made before a hot reload is looked up again by its name hash */
+template<typename T>
+class UniformHandle
 {
-	std::string VertexSource;
-	std::string FragmentSource;
+private:
+	int m_Location;
+	uint64_t m_NameHash;
+	unsigned int m_Generation;
+
+public:
+	UniformHandle()
+		: m_Location(-1), m_NameHash(0), m_Generation(0) {}
+	UniformHandle(int location, uint64_t nameHash, unsigned int generation)
+		: m_Location(location), m_NameHash(nameHash), m_Generation(generation) {}
+
+	inline int GetLocation() const { return m_Location; }
+	inline uint64_t GetNameHash() const { return m_NameHash; }
+	inline unsigned int GetGeneration() const { return m_Generation; }
+	inline bool IsValid() const { return m_Location != -1; }
 };
 
 class Shader
 {
+public:
+	struct CacheStats
+	{
+		unsigned int Hits;
+		unsigned int Misses;
+	};
+
 private:
+	/* Linked programs are stored in this directory, keyed by a hash of the
+	   source and the GL vendor/renderer/version strings */
+	static const char* s_ProgramCacheDirectory;
+	static bool s_ProgramCacheEnabled;
+	static CacheStats s_CacheStats;
+
 	std::string m_FilePath;
 	unsigned int m_RendererID;
-	std::unordered_map<std::string, int> m_UniformLocationCache;
+	uint64_t m_Key;
+	std::string m_CachePath;
+	bool m_Linked;
+
+	/* Kept to preprocess the file again on a hot reload, see AssetWatcher */
+	ShaderDefines m_Defines;
+	std::vector<std::string> m_Includes;
+	/* Bumped every time a reload swaps the program */
+	unsigned int m_Generation;
+
+	/* Stages of a link that has been issued but not checked yet, 0 for stages not in the file */
+	unsigned int m_PendingStages[(int)ShaderStage::Count];
+	bool m_Pending;
+
+	/* Active uniforms enumerated after linking, keyed by HashString of the name.
+	   Arrays are stored under their plain name (u_Textures rather than u_Textures[0]) */
+	struct UniformInfo
+	{
+		int Location;
+		unsigned int Type;
+	};
+	std::unordered_map<uint64_t, UniformInfo> m_Uniforms;
 
 public:
-	Shader(const std::string& filepath);
+	Shader(const std::string& filepath, const ShaderDefines& defines = ShaderDefines());
+	/* Build from .shader text already in memory, e.g. a range of a mapped AssetPack.
+	   name is where includes are relative to, resolver supplies them, see ShaderPreprocessor */
+	Shader(const std::string& name, std::string_view source, const ShaderDefines& defines = ShaderDefines(),
+		const ShaderIncludeResolver& resolver = nullptr);
 	~Shader();
 
+	/* Safe to bind: compiled, collected by its ShaderLibrary if deferred, and linked */
+	inline bool IsReady() const { return !m_Pending && m_Linked; }
+	/* True while a deferred compile hasn't been collected by its ShaderLibrary */
+	inline bool IsCompiling() const { return m_Pending; }
+	/* False once a link has failed, such a shader never becomes ready */
+	inline bool IsLinked() const { return m_Linked; }
+	static bool IsParallelCompileSupported();
+	static bool IsStageSupported(ShaderStage stage);
+
+	/* ShaderProgramSource::Key of the preprocessed source, the same for identical variants */
+	inline uint64_t GetKey() const { return m_Key; }
+	inline const std::string& GetFilePath() const { return m_FilePath; }
+	inline unsigned int GetGeneration() const { return m_Generation; }
+	/* True when path is the file itself or one it includes */
+	bool DependsOn(const std::string& path) const;
+
+	/* Build the program again from the file, or from its new contents, and swap it in
+	   with the uniform values carried over. On failure the old program stays */
+	bool Reload();
+	bool Reload(std::string_view source);
+
 	void Bind() const;
 	void Unbind() const;
 
 	// Set Uniforms
-	void SetUniform1i(const std::string name, int value);
-	void SetUniform4f(const std::string name, float v0, float v1, float v2, float v3);
-	void SetUniformMat4f(const std::string name, const glm::mat4& matrix);
+	void SetUniform1i(const std::string& name, int value);
+	void SetUniform1iv(const std::string& name, int count, const int* values);
+	void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
+	void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
+
+	/* Look a uniform up once, e.g. GetUniform<glm::mat4>(HashString("u_Model")).
+	   Needs a ready shader, and warns when T doesn't match the declared GLSL type */
+	template<typename T>
+	UniformHandle<T> GetUniform(uint64_t nameHash) const;
+
+	/* Set through a handle, the shader has to be bound */
+	void SetUniform(UniformHandle<int> uniform, int value);
+	void SetUniform(UniformHandle<float> uniform, float value);
+	void SetUniform(UniformHandle<glm::vec2> uniform, const glm::vec2& value);
+	void SetUniform(UniformHandle<glm::vec4> uniform, const glm::vec4& value);
+	void SetUniform(UniformHandle<glm::mat4> uniform, const glm::mat4& value);
+
+	static void SetProgramCacheEnabled(bool enabled) { s_ProgramCacheEnabled = enabled; }
+	static bool IsProgramCacheEnabled() { return s_ProgramCacheEnabled; }
+	static const CacheStats& GetCacheStats() { return s_CacheStats; }
 
 private:
-	ShaderProgramSource ParseShader(const std::string& filepath);
-	unsigned int CompileShader(unsigned int type, const std::string& source);
-	unsigned int CreateShader(const std::string & vertexShader, const std::string& fragmentShader);;
+	/* Deferred shaders only issue the compile and link, see ShaderLibrary */
+	friend class ShaderLibrary;
+	friend class ShaderVariantSet;
+	Shader(const std::string& filepath, const ShaderProgramSource& source, bool deferred);
+	bool PollCompile();
+
+	void Build(const ShaderProgramSource& source, bool deferred);
+	bool Rebuild(const ShaderProgramSource& source);
+	void CopyUniformValues(unsigned int fromProgram, const std::unordered_map<uint64_t, UniformInfo>& fromUniforms);
+
+	unsigned int CompileShader(ShaderStage stage, const std::string& source);
+	bool CheckCompileStatus(unsigned int id, ShaderStage stage);
+	unsigned int CreateShader(const ShaderProgramSource& source);
+	bool FinishCreate();
+	void BindUniformBlocks();
+	void ReflectUniforms();
+
+	std::string GetProgramCachePath(const ShaderProgramSource& source);
+	unsigned int LoadProgramBinary(const std::string& cachePath);
+	void SaveProgramBinary(unsigned int program, const std::string& cachePath);
 
 	int GetUniformLocation(const std::string& name);
+	template<typename T>
+	int GetUniformLocation(UniformHandle<T> uniform) const;
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "ShaderLibrary.h"
+
+#include "Renderer.h"
+
+ShaderLibrary::ShaderLibrary()
+{
+	/* Let the driver pick how many compiler threads to use */
+	if (GLEW_KHR_parallel_shader_compile)
+	{
+		GLCall(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+	}
+	else if (GLEW_ARB_parallel_shader_compile)
+	{
+		GLCall(glMaxShaderCompilerThreadsARB(0xFFFFFFFF));
+	}
+}
+
+ShaderLibrary::~ShaderLibrary()
+{
+}
+
+ShaderHandle ShaderLibrary::Load(const std::string& name, const std::string& filepath, const ShaderDefines& defines)
+{
+	auto it = m_Shaders.find(name);
+	if (it != m_Shaders.end())
+		return ShaderHandle(it->second);
+
+	/* Preprocessing is cheap next to compiling, and tells whether this variant already exists */
+	ShaderProgramSource source = ShaderPreprocessor::ProcessFile(filepath, defines);
+	auto program = m_Programs.find(source.Key);
+	if (program != m_Programs.end())
+	{
+		m_Shaders[name] = program->second;
+		return ShaderHandle(program->second);
+	}
+
+	std::shared_ptr<Shader> shader(new Shader(filepath, source, true));
+	m_Shaders[name] = shader;
+	m_Programs[source.Key] = shader;
+	/* Program binary cache hits are ready straight away */
+	if (shader->IsCompiling())
+		m_Pending.push_back(shader);
+	return ShaderHandle(shader);
+}
+
+ShaderHandle ShaderLibrary::Get(const std::string& name) const
+{
+	auto it = m_Shaders.find(name);
+	if (it == m_Shaders.end())
+		return ShaderHandle();
+	return ShaderHandle(it->second);
+}
+
+void ShaderLibrary::Update()
+{
+	bool parallel = Shader::IsParallelCompileSupported();
+	for (auto it = m_Pending.begin(); it != m_Pending.end();)
+	{
+		if ((*it)->PollCompile())
+		{
+			it = m_Pending.erase(it);
+			if (!parallel)
+				break;
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+void ShaderLibrary::WaitAll()
+{
+	while (!m_Pending.empty())
+		Update();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Shader.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Future-like reference to a shader that may still be compiling */
+class ShaderHandle
+{
+private:
+	std::shared_ptr<Shader> m_Shader;
+
+public:
+	ShaderHandle() {}
+	ShaderHandle(const std::shared_ptr<Shader>& shader)
+		: m_Shader(shader) {}
+
+	/* Check before drawing, a shader that isn't ready must not be bound.
+	   Becomes true once ShaderLibrary::Update has collected the shader, and stays
+	   false if it failed to compile or link */
+	bool IsReady() const { return m_Shader && m_Shader->IsReady(); }
+
+	Shader& Get() const { return *m_Shader; }
+	Shader* operator->() const { return m_Shader.get(); }
+};
+
+/* Submits every program up front and lets the driver compile them in parallel
+   (GL_KHR_parallel_shader_compile), collecting the finished ones once per frame.
+   Names whose preprocessed source is identical share one program */
+class ShaderLibrary
+{
+private:
+	std::unordered_map<std::string, std::shared_ptr<Shader>> m_Shaders;
+	/* Keyed by ShaderProgramSource::Key */
+	std::unordered_map<uint64_t, std::shared_ptr<Shader>> m_Programs;
+	std::vector<std::shared_ptr<Shader>> m_Pending;
+
+public:
+	ShaderLibrary();
+	~ShaderLibrary();
+
+	ShaderHandle Load(const std::string& name, const std::string& filepath, const ShaderDefines& defines = ShaderDefines());
+	ShaderHandle Get(const std::string& name) const;
+
+	/* Call once per frame. Without the extension only one shader is finished per
+	   call, so the blocking status checks are spread over several frames */
+	void Update();
+	void WaitAll();
+
+	inline unsigned int GetPendingCount() const { return (unsigned int)m_Pending.size(); }
+	inline unsigned int GetShaderCount() const { return (unsigned int)m_Shaders.size(); }
+	inline unsigned int GetProgramCount() const { return (unsigned int)m_Programs.size(); }
+};
@@ -0,0 +1,253 @@
+#include "ShaderPreprocessor.h"
+
+#include "Hash.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unordered_set>
+
+std::unordered_map<std::string, std::string> ShaderPreprocessor::s_IncludeCache;
+std::mutex ShaderPreprocessor::s_IncludeMutex;
+
+/* Deep enough for any real chain, shallow enough to stop a file including itself through another */
+static const int s_MaxIncludeDepth = 16;
+
+static const char* s_StageNames[(int)ShaderStage::Count] =
+{
+	"vertex", "fragment", "geometry", "tess_control", "tess_evaluation", "compute",
+};
+
+const char* GetShaderStageName(ShaderStage stage)
+{
+	return stage < ShaderStage::Count ? s_StageNames[(int)stage] : "unknown";
+}
+
+struct ShaderPreprocessor::State
+{
+	ShaderProgramSource Result;
+	int Stage;									// -1 until the first #shader line
+	size_t DefinesAt[(int)ShaderStage::Count];	// just after the stage's #version line
+	std::unordered_set<std::string> Included[(int)ShaderStage::Count];
+	const ShaderIncludeResolver* Resolver;		// nullptr to read includes from disk
+};
+
+static std::string_view Trim(std::string_view str)
+{
+	const char* whitespace = " \t\r";
+	size_t start = str.find_first_not_of(whitespace);
+	if (start == std::string_view::npos)
+		return std::string_view();
+	size_t end = str.find_last_not_of(whitespace);
+	return str.substr(start, end - start + 1);
+}
+
+/* For "#name args" returns name and sets args, for any other line returns an empty view */
+static std::string_view GetDirective(std::string_view line, std::string_view& args)
+{
+	line = Trim(line);
+	if (line.empty() || line[0] != '#')
+		return std::string_view();
+
+	line = Trim(line.substr(1));
+	size_t nameEnd = line.find_first_of(" \t");
+	if (nameEnd == std::string_view::npos)
+	{
+		args = std::string_view();
+		return line;
+	}
+	args = Trim(line.substr(nameEnd));
+	return line.substr(0, nameEnd);
+}
+
+ShaderProgramSource ShaderPreprocessor::Process(std::string_view source, const std::string& filepath, const ShaderDefines& defines,
+	const ShaderIncludeResolver& resolver)
+{
+	State state;
+	state.Stage = -1;
+	state.Resolver = resolver ? &resolver : nullptr;
+	for (size_t& definesAt : state.DefinesAt)
+		definesAt = std::string::npos;
+
+	Expand(state, source, 0, filepath, 0);
+
+	ShaderProgramSource& result = state.Result;
+	for (int i = 0; i < (int)ShaderStage::Count; i++)
+	{
+		std::string& stage = result.Stages[i];
+		if (stage.empty() || defines.empty())
+			continue;
+
+		/* Now that the whole stage is known, leave out defines it never mentions */
+		std::string lines;
+		for (const auto& define : defines)
+		{
+			if (stage.find(define.first) != std::string::npos)
+				lines += "#define " + define.first + " " + define.second + '\n';
+		}
+		stage.insert(state.DefinesAt[i] == std::string::npos ? 0 : state.DefinesAt[i], lines);
+	}
+
+	result.Defines = defines;
+	result.Key = HashOffsetBasis;
+	for (int i = 0; i < (int)ShaderStage::Count; i++)
+	{
+		/* Mix the stage in so moving code between stages changes the key */
+		uint64_t header[2] = { (uint64_t)i, (uint64_t)result.Stages[i].size() };
+		result.Key = HashBytes(header, sizeof(header), result.Key);
+		result.Key = HashBytes(result.Stages[i].data(), result.Stages[i].size(), result.Key);
+	}
+	return std::move(result);
+}
+
+ShaderProgramSource ShaderPreprocessor::ProcessFile(const std::string& filepath, const ShaderDefines& defines)
+{
+	std::ifstream stream(filepath, std::ios::binary);
+	if (!stream)
+		std::cout << "Warning: could not open shader '" << filepath << "'" << std::endl;
+	std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	return Process(contents, filepath, defines);
+}
+
+void ShaderPreprocessor::ClearIncludeCache()
+{
+	std::lock_guard<std::mutex> lock(s_IncludeMutex);
+	s_IncludeCache.clear();
+}
+
+void ShaderPreprocessor::InvalidateInclude(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(s_IncludeMutex);
+	s_IncludeCache.erase(std::filesystem::path(path).lexically_normal().generic_string());
+}
+
+void ShaderPreprocessor::SetInclude(const std::string& path, std::string contents)
+{
+	std::string normalised = std::filesystem::path(path).lexically_normal().generic_string();
+	std::lock_guard<std::mutex> lock(s_IncludeMutex);
+	s_IncludeCache[normalised] = std::move(contents);
+}
+
+void ShaderPreprocessor::Expand(State& state, std::string_view source, int sourceIndex, const std::string& filepath, int depth)
+{
+	/* Includes are looked up next to the file doing the including */
+	size_t slash = filepath.find_last_of("/\\");
+	std::string directory = slash == std::string::npos ? std::string() : filepath.substr(0, slash + 1);
+
+	int lineNumber = 0;
+	size_t lineStart = 0;
+	while (lineStart < source.size())
+	{
+		size_t lineEnd = source.find('\n', lineStart);
+		if (lineEnd == std::string_view::npos)
+			lineEnd = source.size();
+		std::string_view line = source.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+		lineNumber++;
+
+		std::string_view args;
+		std::string_view directive = GetDirective(line, args);
+
+		if (directive == "shader")
+		{
+			if (depth > 0)
+			{
+				std::cout << "Warning: #shader in included file " << filepath << " is ignored" << std::endl;
+				continue;
+			}
+
+			state.Stage = -1;
+			for (int i = 0; i < (int)ShaderStage::Count; i++)
+			{
+				if (args == s_StageNames[i])
+					state.Stage = i;
+			}
+			if (state.Stage == -1)
+				std::cout << "Warning: unknown shader stage '" << args << "' in " << filepath << std::endl;
+			continue;
+		}
+
+		/* Lines before the first #shader, or in an unknown stage, belong to nothing */
+		if (state.Stage == -1)
+			continue;
+		std::string& out = state.Result.Stages[state.Stage];
+
+		if (directive == "include")
+		{
+			if (args.size() < 2 || !((args.front() == '"' && args.back() == '"') || (args.front() == '<' && args.back() == '>')))
+			{
+				std::cout << "Warning: malformed #include in " << filepath << ":" << lineNumber << std::endl;
+				out += '\n';
+				continue;
+			}
+
+			std::string path = std::filesystem::path(directory + std::string(args.substr(1, args.size() - 2))).lexically_normal().generic_string();
+			/* Skipped includes leave a blank line so the numbering below stays right */
+			if (!state.Included[state.Stage].insert(path).second)
+			{
+				out += '\n';
+				continue;
+			}
+			if (depth >= s_MaxIncludeDepth)
+			{
+				std::cout << "Warning: includes nested too deeply at " << filepath << ":" << lineNumber << std::endl;
+				out += '\n';
+				continue;
+			}
+
+			std::string contents;
+			if (state.Resolver ? !(*state.Resolver)(path, contents) : !LoadInclude(path, contents))
+			{
+				std::cout << "Warning: could not open include '" << path << "' from " << filepath << std::endl;
+				out += '\n';
+				continue;
+			}
+
+			std::vector<std::string>& includes = state.Result.Includes;
+			int includeIndex = (int)(std::find(includes.begin(), includes.end(), path) - includes.begin());
+			if (includeIndex == (int)includes.size())
+				includes.push_back(path);
+
+			/* Keep compiler messages pointing at the right file and line */
+			out += "#line 1 " + std::to_string(includeIndex + 1) + '\n';
+			Expand(state, contents, includeIndex + 1, path, depth + 1);
+			out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceIndex) + '\n';
+			continue;
+		}
+
+		out.append(line);
+		out += '\n';
+
+		if (directive == "version" && state.DefinesAt[state.Stage] == std::string::npos)
+		{
+			/* Defines go here once the stage is complete, the #line keeps numbering as in the file */
+			state.DefinesAt[state.Stage] = out.size();
+			out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceIndex) + '\n';
+		}
+	}
+}
+
+/* Copies out under the lock, a cache entry can be replaced while the caller expands it */
+bool ShaderPreprocessor::LoadInclude(const std::string& path, std::string& contents)
+{
+	{
+		std::lock_guard<std::mutex> lock(s_IncludeMutex);
+		auto it = s_IncludeCache.find(path);
+		if (it != s_IncludeCache.end())
+		{
+			contents = it->second;
+			return true;
+		}
+	}
+
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+		return false;
+
+	contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	std::lock_guard<std::mutex> lock(s_IncludeMutex);
+	s_IncludeCache.emplace(path, contents);
+	return true;
+}
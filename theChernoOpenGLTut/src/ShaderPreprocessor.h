@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/* Sections of a .shader file, selected with #shader <name> */
+enum class ShaderStage
+{
+	Vertex = 0,			// vertex
+	Fragment,			// fragment
+	Geometry,			// geometry
+	TessControl,		// tess_control
+	TessEvaluation,		// tess_evaluation
+	Compute,			// compute
+	Count
+};
+
+const char* GetShaderStageName(ShaderStage stage);
+
+/* Name/value pairs injected as #define lines after each #version directive */
+using ShaderDefines = std::map<std::string, std::string>;
+
+struct ShaderProgramSource
+{
+	/* Empty for stages the file doesn't have */
+	std::string Stages[(int)ShaderStage::Count];
+	/* Files pulled in with #include, #line source string n + 1 refers to Includes[n] */
+	std::vector<std::string> Includes;
+	/* What it was processed with, so it can be processed again after an edit */
+	ShaderDefines Defines;
+	/* Hash of every stage after preprocessing, equal keys compile to the same program */
+	uint64_t Key;
+
+	inline bool Has(ShaderStage stage) const { return !Stages[(int)stage].empty(); }
+	inline const std::string& Get(ShaderStage stage) const { return Stages[(int)stage]; }
+};
+
+/* Supplies an included file by its normalised path, e.g. "res/shaders/Common.glsl", and
+   returns false when there is no such file */
+using ShaderIncludeResolver = std::function<bool(const std::string& path, std::string& contents)>;
+
+/* Splits .shader text into stages in one pass over the buffer, expanding #include "path"
+   (relative to the including file, each file once per stage) and adding the defines a stage
+   actually mentions after its #version. Variants that only differ in defines a shader
+   never looks at end up with the same Key */
+class ShaderPreprocessor
+{
+private:
+	/* Contents of every included file by path, read from disk once. Locked since shaders
+	   can be preprocessed off the main thread */
+	static std::unordered_map<std::string, std::string> s_IncludeCache;
+	static std::mutex s_IncludeMutex;
+
+public:
+	/* Includes come from resolver when given, e.g. AssetPack::GetIncludeResolver, otherwise
+	   from disk through the include cache */
+	static ShaderProgramSource Process(std::string_view source, const std::string& filepath, const ShaderDefines& defines = ShaderDefines(),
+		const ShaderIncludeResolver& resolver = nullptr);
+	/* Reads filepath and processes it, all stages are empty when it can't be read */
+	static ShaderProgramSource ProcessFile(const std::string& filepath, const ShaderDefines& defines = ShaderDefines());
+
+	/* Forget cached include files, or replace one with contents already read, e.g. after an edit */
+	static void ClearIncludeCache();
+	static void InvalidateInclude(const std::string& path);
+	static void SetInclude(const std::string& path, std::string contents);
+
+private:
+	struct State;
+	static void Expand(State& state, std::string_view source, int sourceIndex, const std::string& filepath, int depth);
+	static bool LoadInclude(const std::string& path, std::string& contents);
+};
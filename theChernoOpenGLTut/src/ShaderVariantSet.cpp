@@ -0,0 +1,152 @@
+#include "ShaderVariantSet.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+ShaderVariantSet::ShaderVariantSet(const std::string& filepath)
+	: m_FilePath(filepath), m_BitCount(0), m_Stats{ 0, 0, 0.0f }
+{
+	ReadSource();
+}
+
+/* Every permutation is preprocessed from this copy, read again only when the file changed */
+void ShaderVariantSet::ReadSource()
+{
+	std::error_code error;
+	m_SourceTime = std::filesystem::last_write_time(m_FilePath, error);
+
+	std::ifstream stream(m_FilePath, std::ios::binary);
+	if (!stream)
+		std::cout << "Warning: could not open shader '" << m_FilePath << "'" << std::endl;
+	m_Source.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+ShaderVariantSet::~ShaderVariantSet()
+{
+}
+
+unsigned int ShaderVariantSet::AddKeyword(const std::string& name)
+{
+	return AddKeyword(name, { "" });
+}
+
+unsigned int ShaderVariantSet::AddKeyword(const std::string& name, const std::vector<std::string>& values)
+{
+	Keyword keyword;
+	if (values.size() == 1 && values[0].empty())
+	{
+		/* Boolean, off defines nothing so the default variant matches the plain file */
+		keyword.Defines = { "", name };
+	}
+	else
+	{
+		for (const std::string& value : values)
+			keyword.Defines.push_back(name + "_" + value);
+	}
+
+	unsigned int bits = 0;
+	while ((1u << bits) < keyword.Defines.size())
+		bits++;
+	if (m_BitCount + bits > sizeof(ShaderVariantKey) * 8)
+	{
+		/* Its bits would overlap another keyword's, so it never leaves the first value */
+		std::cout << "Error: keyword " << name << " doesn't fit in the variant key of " << m_FilePath << std::endl;
+		keyword.Shift = 0;
+		keyword.Mask = 0;
+	}
+	else
+	{
+		keyword.Shift = m_BitCount;
+		keyword.Mask = (1u << bits) - 1;
+		m_BitCount += bits;
+	}
+
+	m_Keywords.push_back(std::move(keyword));
+	return (unsigned int)m_Keywords.size() - 1;
+}
+
+ShaderVariantKey ShaderVariantSet::Select(ShaderVariantKey key, unsigned int keyword, unsigned int value) const
+{
+	const Keyword& k = m_Keywords[keyword];
+	return (key & ~(k.Mask << k.Shift)) | ((value & k.Mask) << k.Shift);
+}
+
+unsigned int ShaderVariantSet::GetValue(ShaderVariantKey key, unsigned int keyword) const
+{
+	const Keyword& k = m_Keywords[keyword];
+	return (key >> k.Shift) & k.Mask;
+}
+
+ShaderDefines ShaderVariantSet::GetDefines(ShaderVariantKey key) const
+{
+	ShaderDefines defines;
+	for (unsigned int i = 0; i < (unsigned int)m_Keywords.size(); i++)
+	{
+		unsigned int value = GetValue(key, i);
+		if (value < m_Keywords[i].Defines.size() && !m_Keywords[i].Defines[value].empty())
+			defines[m_Keywords[i].Defines[value]] = "1";
+	}
+	return defines;
+}
+
+Shader& ShaderVariantSet::Get(ShaderVariantKey key)
+{
+	m_Stats.Requests++;
+	auto it = m_Variants.find(key);
+	if (it != m_Variants.end())
+		return *it->second;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	/* Compiled permutations follow edits through AssetWatcher, new ones need the edit too */
+	std::error_code error;
+	if (std::filesystem::last_write_time(m_FilePath, error) != m_SourceTime)
+		ReadSource();
+
+	ShaderProgramSource source = ShaderPreprocessor::Process(m_Source, m_FilePath, GetDefines(key));
+	std::shared_ptr<Shader>& program = m_Programs[source.Key];
+	if (!program)
+	{
+		program.reset(new Shader(m_FilePath, source, false));
+		m_Stats.Compiled++;
+	}
+	m_Variants[key] = program;
+
+	auto end = std::chrono::high_resolution_clock::now();
+	m_Stats.CompileTime += std::chrono::duration<float, std::milli>(end - start).count();
+	return *program;
+}
+
+unsigned int ShaderVariantSet::GetPermutationCount() const
+{
+	unsigned int count = 1;
+	for (const Keyword& keyword : m_Keywords)
+	{
+		if (keyword.Mask != 0)
+			count *= (unsigned int)keyword.Defines.size();
+	}
+	return count;
+}
+
+std::vector<ShaderVariantKey> ShaderVariantSet::GetPermutationKeys() const
+{
+	/* Keys aren't dense: a keyword with three values still takes two bits */
+	std::vector<ShaderVariantKey> keys = { 0 };
+	for (unsigned int i = 0; i < (unsigned int)m_Keywords.size(); i++)
+	{
+		if (m_Keywords[i].Mask == 0)
+			continue;
+
+		std::vector<ShaderVariantKey> combined;
+		for (ShaderVariantKey key : keys)
+		{
+			for (unsigned int value = 0; value < (unsigned int)m_Keywords[i].Defines.size(); value++)
+				combined.push_back(Select(key, i, value));
+		}
+		keys = std::move(combined);
+	}
+	return keys;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Shader.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* One value per keyword packed into bits, 0 selects the first value of every keyword */
+using ShaderVariantKey = uint32_t;
+
+/* Permutations of one .shader file selected by keywords. A permutation is only
+   preprocessed and compiled the first time Get asks for it, then kept in memory;
+   the program binary cache makes it cheap on later runs as well.
+
+	boolean keyword "INSTANCED"					defines INSTANCED when on
+	enum keyword "ALPHA" { "OPAQUE", "TEST" }	defines ALPHA_OPAQUE or ALPHA_TEST */
+class ShaderVariantSet
+{
+public:
+	struct Stats
+	{
+		unsigned int Requests;
+		unsigned int Compiled;
+		float CompileTime;	// ms spent building permutations
+	};
+
+private:
+	struct Keyword
+	{
+		std::vector<std::string> Defines;	// per value, empty for a boolean that is off
+		unsigned int Shift, Mask;
+	};
+
+	std::string m_FilePath;
+	std::string m_Source;
+	std::filesystem::file_time_type m_SourceTime;
+	std::vector<Keyword> m_Keywords;
+	unsigned int m_BitCount;
+
+	std::unordered_map<ShaderVariantKey, std::shared_ptr<Shader>> m_Variants;
+	/* By ShaderProgramSource::Key, so keys that preprocess to the same text share a program */
+	std::unordered_map<uint64_t, std::shared_ptr<Shader>> m_Programs;
+	Stats m_Stats;
+
+public:
+	ShaderVariantSet(const std::string& filepath);
+	~ShaderVariantSet();
+
+	/* Keywords have to be added before the first Get, returns the keyword index. All of them
+	   share the 32 bit key, one that doesn't fit is reported and stays at its first value */
+	unsigned int AddKeyword(const std::string& name);
+	unsigned int AddKeyword(const std::string& name, const std::vector<std::string>& values);
+
+	/* key with keyword set to value, e.g. Select(Select(0, instanced, 1), alpha, 1) */
+	ShaderVariantKey Select(ShaderVariantKey key, unsigned int keyword, unsigned int value) const;
+	unsigned int GetValue(ShaderVariantKey key, unsigned int keyword) const;
+	ShaderDefines GetDefines(ShaderVariantKey key) const;
+
+	/* Builds the permutation on the first request, blocking until it is linked */
+	Shader& Get(ShaderVariantKey key);
+	inline bool IsCompiled(ShaderVariantKey key) const { return m_Variants.find(key) != m_Variants.end(); }
+
+	unsigned int GetPermutationCount() const;
+	/* Every valid key, one per combination of keyword values */
+	std::vector<ShaderVariantKey> GetPermutationKeys() const;
+	inline unsigned int GetProgramCount() const { return (unsigned int)m_Programs.size(); }
+	inline const Stats& GetStats() const { return m_Stats; }
+
+private:
+	void ReadSource();
+};
@@ -0,0 +1,167 @@
+#include "StateCache.h"
+
+#include "Renderer.h"
+
+/* Marks a binding whose real value is not known, so the next bind is always issued */
+static const unsigned int s_Unknown = 0xFFFFFFFF;
+
+StateCache::StateCache()
+	: m_Stats{ 0, 0 }
+{
+	Invalidate();
+}
+
+StateCache& StateCache::Get()
+{
+	static StateCache instance;
+	return instance;
+}
+
+void StateCache::UseProgram(unsigned int program)
+{
+	if (m_Program == program)
+	{
+		m_Stats.Elided++;
+		return;
+	}
+
+	GLCall(glUseProgram(program));
+	m_Program = program;
+	m_Stats.Issued++;
+}
+
+void StateCache::BindVertexArray(unsigned int vertexArray)
+{
+	if (m_VertexArray == vertexArray)
+	{
+		m_Stats.Elided++;
+		return;
+	}
+
+	GLCall(glBindVertexArray(vertexArray));
+	m_VertexArray = vertexArray;
+	m_Stats.Issued++;
+}
+
+void StateCache::BindArrayBuffer(unsigned int buffer)
+{
+	if (m_ArrayBuffer == buffer)
+	{
+		m_Stats.Elided++;
+		return;
+	}
+
+	GLCall(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+	m_ArrayBuffer = buffer;
+	m_Stats.Issued++;
+}
+
+void StateCache::BindElementBuffer(unsigned int buffer)
+{
+	if (m_VertexArray != s_Unknown)
+	{
+		auto it = m_ElementBuffers.find(m_VertexArray);
+		if (it != m_ElementBuffers.end() && it->second == buffer)
+		{
+			m_Stats.Elided++;
+			return;
+		}
+	}
+
+	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer));
+	if (m_VertexArray != s_Unknown)
+		m_ElementBuffers[m_VertexArray] = buffer;
+	m_Stats.Issued++;
+}
+
+void StateCache::ActiveTexture(unsigned int unit)
+{
+	if (m_ActiveTextureUnit == unit)
+	{
+		m_Stats.Elided++;
+		return;
+	}
+
+	GLCall(glActiveTexture(GL_TEXTURE0 + unit));
+	m_ActiveTextureUnit = unit;
+	m_Stats.Issued++;
+}
+
+void StateCache::BindTexture2D(unsigned int unit, unsigned int texture)
+{
+	/* Units past the tracked range are passed straight through */
+	if (unit >= MaxTextureUnits)
+	{
+		ActiveTexture(unit);
+		GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+		m_Stats.Issued++;
+		return;
+	}
+
+	if (m_Textures[unit] == texture)
+	{
+		m_Stats.Elided++;
+		return;
+	}
+
+	ActiveTexture(unit);
+	GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+	m_Textures[unit] = texture;
+	m_Stats.Issued++;
+}
+
+void StateCache::OnProgramDeleted(unsigned int program)
+{
+	/* A current program is only flagged for deletion, its name may still come back */
+	if (m_Program == program)
+		m_Program = s_Unknown;
+}
+
+void StateCache::OnVertexArrayDeleted(unsigned int vertexArray)
+{
+	/* Deleting the bound VAO reverts the binding to zero */
+	if (m_VertexArray == vertexArray)
+		m_VertexArray = 0;
+	m_ElementBuffers.erase(vertexArray);
+}
+
+void StateCache::OnBufferDeleted(unsigned int buffer)
+{
+	if (m_ArrayBuffer == buffer)
+		m_ArrayBuffer = 0;
+
+	/* Only the current VAO loses the attachment, other VAOs keep the orphaned
+	   buffer alive, so their entries can no longer be trusted */
+	for (auto it = m_ElementBuffers.begin(); it != m_ElementBuffers.end();)
+	{
+		if (it->second == buffer)
+			it = m_ElementBuffers.erase(it);
+		else
+			++it;
+	}
+}
+
+void StateCache::OnTextureDeleted(unsigned int texture)
+{
+	for (unsigned int i = 0; i < MaxTextureUnits; i++)
+	{
+		if (m_Textures[i] == texture)
+			m_Textures[i] = 0;
+	}
+}
+
+void StateCache::Invalidate()
+{
+	m_Program = s_Unknown;
+	m_VertexArray = s_Unknown;
+	m_ArrayBuffer = s_Unknown;
+	m_ActiveTextureUnit = s_Unknown;
+	for (unsigned int i = 0; i < MaxTextureUnits; i++)
+		m_Textures[i] = s_Unknown;
+	m_ElementBuffers.clear();
+}
+
+void StateCache::ResetStats()
+{
+	m_Stats = { 0, 0 };
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <unordered_map>
+
+/* Mirrors the GL bindings of the current context so redundant binds can be skipped.
+   Every bind of a tracked target has to go through here for the mirror to stay valid */
+class StateCache
+{
+public:
+	static const unsigned int MaxTextureUnits = 32;
+
+	struct Stats
+	{
+		unsigned int Issued;
+		unsigned int Elided;
+	};
+
+private:
+	unsigned int m_Program;
+	unsigned int m_VertexArray;
+	unsigned int m_ArrayBuffer;
+	unsigned int m_ActiveTextureUnit;
+	unsigned int m_Textures[MaxTextureUnits];
+
+	/* GL_ELEMENT_ARRAY_BUFFER is part of the VAO state, so it is tracked per VAO */
+	std::unordered_map<unsigned int, unsigned int> m_ElementBuffers;
+
+	Stats m_Stats;
+
+	StateCache();
+
+public:
+	/* There is only the one context, so there is only the one cache */
+	static StateCache& Get();
+
+	void UseProgram(unsigned int program);
+	void BindVertexArray(unsigned int vertexArray);
+	void BindArrayBuffer(unsigned int buffer);
+	void BindElementBuffer(unsigned int buffer);
+	void ActiveTexture(unsigned int unit);
+	void BindTexture2D(unsigned int unit, unsigned int texture);
+
+	/* Forget deleted objects so a recycled name is not mistaken for the bound one */
+	void OnProgramDeleted(unsigned int program);
+	void OnVertexArrayDeleted(unsigned int vertexArray);
+	void OnBufferDeleted(unsigned int buffer);
+	void OnTextureDeleted(unsigned int texture);
+
+	/* Mark everything as unknown, e.g. after code that binds behind the cache's back */
+	void Invalidate();
+
+	inline const Stats& GetStats() const { return m_Stats; }
+	void ResetStats();
+};
@@ -0,0 +1,124 @@
+#include "StreamingVertexBuffer.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+
+#include <cstring>
+
+StreamingVertexBuffer::StreamingVertexBuffer(unsigned int stride, unsigned int regionVertices, unsigned int regionCount)
+	: m_RendererID(0), m_Stride(stride), m_RegionVertices(regionVertices), m_RegionCount(regionCount),
+	m_CurrentRegion(0), m_WriteVertex(0), m_Fences(regionCount, nullptr),
+	m_Persistent(GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage), m_MappedData(nullptr)
+{
+	GLsizeiptr size = (GLsizeiptr)m_Stride * m_RegionVertices * m_RegionCount;
+
+	GLCall(glGenBuffers(1, &m_RendererID));
+	StateCache::Get().BindArrayBuffer(m_RendererID);
+
+	if (m_Persistent)
+	{
+		/* Immutable storage mapped for the lifetime of the buffer, coherent so
+		   writes are visible to the GPU without an explicit flush */
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		GLCall(glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags));
+		GLCall(m_MappedData = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+	}
+	else
+	{
+		GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW));
+	}
+
+	BeginRegion();
+}
+
+StreamingVertexBuffer::~StreamingVertexBuffer()
+{
+	for (GLsync fence : m_Fences)
+	{
+		if (fence)
+		{
+			GLCall(glDeleteSync(fence));
+		}
+	}
+
+	if (m_Persistent)
+	{
+		StateCache::Get().BindArrayBuffer(m_RendererID);
+		GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+	}
+
+	GLCall(glDeleteBuffers(1, &m_RendererID));
+	StateCache::Get().OnBufferDeleted(m_RendererID);
+}
+
+void StreamingVertexBuffer::BeginRegion()
+{
+	m_CurrentRegion = (m_CurrentRegion + 1) % m_RegionCount;
+	m_WriteVertex = 0;
+
+	GLsync& fence = m_Fences[m_CurrentRegion];
+	if (!fence)
+		return;
+
+	/* Only blocks when the GPU is more than regionCount regions behind */
+	GLenum result = GL_TIMEOUT_EXPIRED;
+	while (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED && result != GL_WAIT_FAILED)
+	{
+		GLCall(result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000));
+	}
+	GLCall(glDeleteSync(fence));
+	fence = nullptr;
+}
+
+void StreamingVertexBuffer::EndRegion()
+{
+	GLsync& fence = m_Fences[m_CurrentRegion];
+	if (fence)
+	{
+		GLCall(glDeleteSync(fence));
+	}
+	GLCall(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+}
+
+unsigned int StreamingVertexBuffer::Write(const void* data, unsigned int vertexCount)
+{
+	ASSERT(vertexCount <= m_RegionVertices);
+
+	/* Spill into the next region when this one is full */
+	if (m_WriteVertex + vertexCount > m_RegionVertices)
+	{
+		EndRegion();
+		BeginRegion();
+	}
+
+	unsigned int firstVertex = m_CurrentRegion * m_RegionVertices + m_WriteVertex;
+	GLintptr offset = (GLintptr)firstVertex * m_Stride;
+	GLsizeiptr size = (GLsizeiptr)vertexCount * m_Stride;
+
+	if (m_Persistent)
+	{
+		memcpy(m_MappedData + offset, data, size);
+	}
+	else
+	{
+		/* The fences already guarantee the range is idle, so the driver doesn't need to sync */
+		StateCache::Get().BindArrayBuffer(m_RendererID);
+		GLCall(void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+		memcpy(mapped, data, size);
+		GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+	}
+
+	m_WriteVertex += vertexCount;
+	return firstVertex;
+}
+
+void StreamingVertexBuffer::Bind() const
+{
+	StateCache::Get().BindArrayBuffer(m_RendererID);
+}
+
+void StreamingVertexBuffer::Unbind() const
+{
+	StateCache::Get().BindArrayBuffer(0);
+}
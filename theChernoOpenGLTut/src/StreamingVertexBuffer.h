@@ -0,0 +1,45 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <vector>
+
+/* Vertex buffer allocated once and written with plain memcpy.
+   The buffer is split into regions that are fenced once the GPU has been given
+   their contents, so the CPU never writes into data a pending draw still reads */
+class StreamingVertexBuffer
+{
+private:
+	unsigned int m_RendererID;
+	unsigned int m_Stride;
+	unsigned int m_RegionVertices;
+	unsigned int m_RegionCount;
+
+	unsigned int m_CurrentRegion;
+	unsigned int m_WriteVertex;
+	std::vector<GLsync> m_Fences;
+
+	/* Persistent mapping of the whole buffer (GL 4.4 / ARB_buffer_storage),
+	   otherwise each write maps its range with GL_MAP_UNSYNCHRONIZED_BIT */
+	bool m_Persistent;
+	unsigned char* m_MappedData;
+
+public:
+	StreamingVertexBuffer(unsigned int stride, unsigned int regionVertices, unsigned int regionCount = 3);
+	~StreamingVertexBuffer();
+
+	/* Wait until the next region is free and start writing into it */
+	void BeginRegion();
+	/* Fence the current region, call once its draws have been issued */
+	void EndRegion();
+
+	/* Copy vertexCount vertices into the current region and return the index of
+	   the first one, to be used as the base vertex of the draw */
+	unsigned int Write(const void* data, unsigned int vertexCount);
+
+	void Bind() const;
+	void Unbind() const;
+
+	inline bool IsPersistent() const { return m_Persistent; }
+	inline unsigned int GetStride() const { return m_Stride; }
+};
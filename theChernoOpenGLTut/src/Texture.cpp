@@ -1,40 +1,301 @@
 #include "Texture.h"
 
+#include "StateCache.h"
+#include "MipChain.h"
+#include "AssetWatcher.h"
+
 #include "stb_image/stb_image.h"
 
-Texture::Texture(const std::string& path)
+#include <algorithm>
+#include <iostream>
+
+Texture::Texture(const std::string& path, const TextureSpec& spec)
 	: m_RendererID(0), m_FilePath(path), m_LocalBuffer(nullptr),
-	m_Width(0), m_Height(0), m_BPP(0)
+	m_Width(0), m_Height(0), m_BPP(0), m_Ready(true), m_Compressed(false), m_Spec(spec),
+	m_MemorySize(0), m_UncompressedSize(0), m_MipLevels(1)
 {
+	AssetWatcher::OnTextureCreated(this);
+
+	if (path.size() > 5 && path.compare(path.size() - 5, 5, ".ctex") == 0)
+	{
+		LoadCompressed(path);
+		return;
+	}
+
 	stbi_set_flip_vertically_on_load(1);
 	m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
-	GLCall(glGenTextures(1, &m_RendererID));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	if (!m_LocalBuffer)
+	{
+		/* Keep a valid texture around so binding it is still safe */
+		std::cout << "Warning: could not load texture '" << path << "'" << std::endl;
+		const unsigned char white[] = { 255, 255, 255, 255 };
+		m_Width = m_Height = 1;
+		m_RendererID = CreateStorage(1, 1, white, m_Spec);
+		SetStorageInfo(1);
+		return;
+	}
 
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	m_RendererID = CreateStorage(m_Width, m_Height, m_LocalBuffer, m_Spec);
+	SetStorageInfo(GetMipLevels(m_Spec, m_Width, m_Height));
+	stbi_image_free(m_LocalBuffer);
+	m_LocalBuffer = nullptr;
+}
+
+Texture::Texture(int width, int height, const TextureSpec& spec)
+	: m_RendererID(0), m_LocalBuffer(nullptr),
+	m_Width(width), m_Height(height), m_BPP(4), m_Ready(true), m_Compressed(false), m_Spec(spec),
+	m_MemorySize(0), m_UncompressedSize(0), m_MipLevels(1)
+{
+	m_RendererID = CreateStorage(m_Width, m_Height, nullptr, m_Spec);
+	SetStorageInfo(GetMipLevels(m_Spec, m_Width, m_Height));
+}
 
-	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
-	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+Texture::Texture(const std::string& name, const unsigned char* pixels, int width, int height, const TextureSpec& spec)
+	: m_RendererID(0), m_FilePath(name), m_LocalBuffer(nullptr),
+	m_Width(width), m_Height(height), m_BPP(4), m_Ready(true), m_Compressed(false), m_Spec(spec),
+	m_MemorySize(0), m_UncompressedSize(0), m_MipLevels(1)
+{
+	AssetWatcher::OnTextureCreated(this);
+	m_RendererID = CreateStorage(m_Width, m_Height, pixels, m_Spec);
+	SetStorageInfo(GetMipLevels(m_Spec, m_Width, m_Height));
+}
 
-	if (m_LocalBuffer)
-		stbi_image_free(m_LocalBuffer);
+Texture::Texture(const std::string& path, const TextureSpec& spec, PlaceholderTag)
+	: m_RendererID(0), m_FilePath(path), m_LocalBuffer(nullptr),
+	m_Width(1), m_Height(1), m_BPP(4), m_Ready(false), m_Compressed(false), m_Spec(spec),
+	m_MemorySize(0), m_UncompressedSize(0), m_MipLevels(1)
+{
+	AssetWatcher::OnTextureCreated(this);
+	const unsigned char white[] = { 255, 255, 255, 255 };
+	m_RendererID = CreateStorage(1, 1, white, m_Spec);
+	SetStorageInfo(1);
 }
 
 Texture::~Texture()
 {
+	AssetWatcher::OnTextureDeleted(this);
 	GLCall(glDeleteTextures(1, &m_RendererID));
+	StateCache::Get().OnTextureDeleted(m_RendererID);
 }
 
 void Texture::Bind(unsigned int slot) const
 {
-	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	StateCache::Get().BindTexture2D(slot, m_RendererID);
+}
+
+void Texture::Unbind(unsigned int slot) const
+{
+	StateCache::Get().BindTexture2D(slot, 0);
+}
+
+void Texture::SetData(int x, int y, int width, int height, const void* pixels, bool updateMips)
+{
+	StateCache::Get().BindTexture2D(0, m_RendererID);
+	GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+	if (updateMips && m_MipLevels > 1)
+	{
+		GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+	}
+	StateCache::Get().BindTexture2D(0, 0);
+}
+
+void Texture::GenerateMips()
+{
+	if (m_MipLevels <= 1)
+		return;
+
+	StateCache::Get().BindTexture2D(0, m_RendererID);
+	GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+	StateCache::Get().BindTexture2D(0, 0);
+}
+
+/* Swap the placeholder for the finished texture */
+void Texture::Replace(unsigned int rendererID, int width, int height)
+{
+	GLCall(glDeleteTextures(1, &m_RendererID));
+	StateCache::Get().OnTextureDeleted(m_RendererID);
+
+	m_RendererID = rendererID;
+	m_Width = width;
+	m_Height = height;
+	m_Ready = true;
+	SetStorageInfo(GetMipLevels(m_Spec, width, height));
+}
+
+void Texture::LoadCompressed(const std::string& path)
+{
+	CompressedImage image;
+	if (ReadCompressedImage(path, image))
+		m_RendererID = CreateCompressedStorage(image, m_Spec);
+	else
+		std::cout << "Warning: could not load texture '" << path << "'" << std::endl;
+
+	if (m_RendererID == 0)
+	{
+		const unsigned char white[] = { 255, 255, 255, 255 };
+		m_Width = m_Height = 1;
+		m_RendererID = CreateStorage(1, 1, white, m_Spec);
+		SetStorageInfo(1);
+		return;
+	}
+
+	size_t memorySize = 0;
+	for (const auto& level : image.Levels)
+		memorySize += level.size();
+
+	m_Width = image.Width;
+	m_Height = image.Height;
+	m_BPP = 4;
+	SetStorageInfo((unsigned int)image.Levels.size(), memorySize);
+}
+
+void Texture::SetStorageInfo(unsigned int levels, size_t memorySize)
+{
+	m_MipLevels = levels;
+	m_UncompressedSize = 0;
+	for (int level = 0, w = m_Width, h = m_Height; level < (int)levels; level++)
+	{
+		m_UncompressedSize += (size_t)w * h * 4;
+		w = std::max(1, w / 2);
+		h = std::max(1, h / 2);
+	}
+	m_Compressed = memorySize != 0;
+	m_MemorySize = m_Compressed ? memorySize : m_UncompressedSize;
+}
+
+unsigned int Texture::GetMipLevels(const TextureSpec& spec, int width, int height)
+{
+	unsigned int fullChain = GetMipLevelCount(width, height);
+	return spec.MipLevels == 0 ? fullChain : std::min(spec.MipLevels, fullChain);
+}
+
+static GLenum GetMinFilter(TextureFilter filter, bool mipmapped)
+{
+	switch (filter)
+	{
+	case TextureFilter::Nearest:	return mipmapped ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST;
+	case TextureFilter::Bilinear:	return mipmapped ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR;
+	case TextureFilter::Trilinear:	return mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+	}
+	return GL_LINEAR;
+}
+
+static GLenum GetWrapMode(TextureWrap wrap)
+{
+	switch (wrap)
+	{
+	case TextureWrap::ClampToEdge:		return GL_CLAMP_TO_EDGE;
+	case TextureWrap::Repeat:			return GL_REPEAT;
+	case TextureWrap::MirroredRepeat:	return GL_MIRRORED_REPEAT;
+	}
+	return GL_CLAMP_TO_EDGE;
+}
+
+/* Filtering, wrapping and anisotropy of the texture bound to GL_TEXTURE_2D */
+static void SetSamplingParameters(const TextureSpec& spec, unsigned int levels)
+{
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GetMinFilter(spec.Filter, levels > 1)));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, spec.Filter == TextureFilter::Nearest ? GL_NEAREST : GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GetWrapMode(spec.Wrap)));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GetWrapMode(spec.Wrap)));
+
+	if (spec.Anisotropy > 1.0f && GLEW_EXT_texture_filter_anisotropic)
+	{
+		float maxAnisotropy = 1.0f;
+		GLCall(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy));
+		GLCall(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(spec.Anisotropy, maxAnisotropy)));
+	}
+}
+
+unsigned int Texture::CreateStorage(int width, int height, const void* data, const TextureSpec& spec)
+{
+	unsigned int levels = GetMipLevels(spec, width, height);
+	GLenum internalFormat = spec.Format == TextureFormat::SRGB8_ALPHA8 ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+
+	unsigned int rendererID;
+	GLCall(glGenTextures(1, &rendererID));
+	StateCache::Get().BindTexture2D(0, rendererID);
+
+	/* Immutable storage is allocated complete, so the driver doesn't have to
+	   re-check the level chain every time the texture is used */
+	if (GLEW_VERSION_4_2 || GLEW_ARB_texture_storage)
+	{
+		GLCall(glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat, width, height));
+		if (data)
+		{
+			GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data));
+		}
+	}
+	else
+	{
+		for (unsigned int level = 0, w = width, h = height; level < levels; level++)
+		{
+			GLCall(glTexImage2D(GL_TEXTURE_2D, level, internalFormat, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, level == 0 ? data : nullptr));
+			w = std::max(1u, w / 2);
+			h = std::max(1u, h / 2);
+		}
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1));
+	}
+
+	SetSamplingParameters(spec, levels);
+
+	if (data && levels > 1)
+	{
+		GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+	}
+
+	StateCache::Get().BindTexture2D(0, 0);
+	return rendererID;
 }
 
-void Texture::Unbind() const
+unsigned int Texture::CreateCompressedStorage(const CompressedImage& image, const TextureSpec& spec)
 {
-	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
-}
\ No newline at end of file
+	if (!GLEW_EXT_texture_compression_s3tc)
+	{
+		std::cout << "Warning: S3TC texture compression is not supported" << std::endl;
+		return 0;
+	}
+
+	bool srgb = spec.Format == TextureFormat::SRGB8_ALPHA8 && GLEW_EXT_texture_sRGB;
+	GLenum internalFormat;
+	if (image.Format == BlockFormat::BC1)
+		internalFormat = srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	else
+		internalFormat = srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+	unsigned int levels = (unsigned int)image.Levels.size();
+	bool immutable = GLEW_VERSION_4_2 || GLEW_ARB_texture_storage;
+
+	unsigned int rendererID;
+	GLCall(glGenTextures(1, &rendererID));
+	StateCache::Get().BindTexture2D(0, rendererID);
+
+	if (immutable)
+	{
+		GLCall(glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat, image.Width, image.Height));
+	}
+
+	/* The blocks go to the GPU as they are, no decoding or conversion on the way */
+	for (unsigned int level = 0, w = image.Width, h = image.Height; level < levels; level++)
+	{
+		const auto& data = image.Levels[level];
+		if (immutable)
+		{
+			GLCall(glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, w, h, internalFormat, (GLsizei)data.size(), data.data()));
+		}
+		else
+		{
+			GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, w, h, 0, (GLsizei)data.size(), data.data()));
+		}
+		w = std::max(1u, w / 2);
+		h = std::max(1u, h / 2);
+	}
+	if (!immutable)
+	{
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1));
+	}
+
+	SetSamplingParameters(spec, levels);
+	StateCache::Get().BindTexture2D(0, 0);
+	return rendererID;
+}
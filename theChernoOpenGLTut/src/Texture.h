@@ -1,7 +1,43 @@
 #pragma once
 
 #include "Renderer.h"
+#include "CompressedImage.h"
 
+enum class TextureFilter
+{
+	Nearest,
+	Bilinear,	// GL_LINEAR, nearest mip level
+	Trilinear,	// GL_LINEAR, blended between mip levels
+};
+
+enum class TextureWrap
+{
+	ClampToEdge,
+	Repeat,
+	MirroredRepeat,
+};
+
+enum class TextureFormat
+{
+	RGBA8,
+	SRGB8_ALPHA8,
+};
+
+/* Sampling and storage options, the defaults match the old hardcoded setup */
+struct TextureSpec
+{
+	TextureFilter Filter = TextureFilter::Bilinear;
+	TextureWrap Wrap = TextureWrap::ClampToEdge;
+	TextureFormat Format = TextureFormat::RGBA8;
+
+	/* 0 builds the full chain down to 1x1. Cooked .ctex files always use the levels they contain */
+	unsigned int MipLevels = 1;
+
+	/* Clamped to what the driver supports, ignored without EXT_texture_filter_anisotropic */
+	float Anisotropy = 1.0f;
+};
+
+/* Loads images through stb_image, or block compressed .ctex files written by texcook */
 class Texture
 {
 private:
@@ -9,15 +45,62 @@ private:
 	std::string m_FilePath;
 	unsigned char* m_LocalBuffer;
 	int m_Width, m_Height, m_BPP;
+	bool m_Ready, m_Compressed;
+	TextureSpec m_Spec;
+
+	/* Bytes of video memory taken by every level, and what RGBA8 would have needed */
+	size_t m_MemorySize, m_UncompressedSize;
+	unsigned int m_MipLevels;
 
 public:
-	Texture(const std::string& path);
+	Texture(const std::string& path, const TextureSpec& spec = TextureSpec());
+	/* Empty RGBA8 texture to be filled in with SetData */
+	Texture(int width, int height, const TextureSpec& spec = TextureSpec());
+	/* Upload already decoded RGBA8 pixels (bottom row first), e.g. straight out of a mapped AssetPack */
+	Texture(const std::string& name, const unsigned char* pixels, int width, int height, const TextureSpec& spec = TextureSpec());
 	~Texture();
 
+	/* Replace a region of level 0 with tightly packed RGBA8 pixels, rebuilding the mips if there are any.
+	   Several updates in a row can pass updateMips false and call GenerateMips once at the end */
+	void SetData(int x, int y, int width, int height, const void* pixels, bool updateMips = true);
+	void GenerateMips();
+
 	void Bind(unsigned int slot = 0) const;
-	void Unbind() const;
+	void Unbind(unsigned int slot = 0) const;
+
+	/* False while a TextureLoader is still working on it, a 1x1 placeholder is bound until then */
+	inline bool IsReady() const { return m_Ready; }
 
 	inline int GetWidth() const { return m_Width; }
 	inline int GetHeight() const { return m_Height; }
-};
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline unsigned int GetMipLevels() const { return m_MipLevels; }
+	inline bool IsCompressed() const { return m_Compressed; }
+	inline size_t GetMemorySize() const { return m_MemorySize; }
+	inline size_t GetUncompressedSize() const { return m_UncompressedSize; }
+	inline const TextureSpec& GetSpec() const { return m_Spec; }
+	inline const std::string& GetFilePath() const { return m_FilePath; }
 
+private:
+	/* Swaps in edited images through Replace */
+	friend class AssetWatcher;
+	/* 1x1 white placeholder for path, filled in later by TextureLoader. The tag only
+	   tells it apart from the public constructor that loads the file */
+	friend class TextureLoader;
+	struct PlaceholderTag {};
+	Texture(const std::string& path, const TextureSpec& spec, PlaceholderTag);
+	void Replace(unsigned int rendererID, int width, int height);
+	void LoadCompressed(const std::string& path);
+	/* memorySize 0 means uncompressed RGBA8 */
+	void SetStorageInfo(unsigned int levels, size_t memorySize = 0);
+
+	/* Levels the spec asks for, limited to the full chain of a width x height image */
+	static unsigned int GetMipLevels(const TextureSpec& spec, int width, int height);
+
+	/* Allocates every level the spec asks for and sets its sampling parameters.
+	   With data, level 0 is filled and the rest built with glGenerateMipmap */
+	static unsigned int CreateStorage(int width, int height, const void* data, const TextureSpec& spec);
+
+	/* Upload every level of a cooked image, returns 0 without S3TC support */
+	static unsigned int CreateCompressedStorage(const CompressedImage& image, const TextureSpec& spec);
+};
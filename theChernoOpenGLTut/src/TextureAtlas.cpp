@@ -0,0 +1,236 @@
+#include "TextureAtlas.h"
+
+#include "stb_image/stb_image.h"
+
+/* imgui_draw.cpp compiles its own private copy of the packer, this one is ours */
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/stb_rect_pack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+/* An image on a page, with its pixels kept so the page can be repacked when it grows */
+struct TextureAtlas::AtlasEntry
+{
+	SubTexture* subTexture;
+	std::vector<unsigned char> pixels;
+	int x, y;
+};
+
+struct TextureAtlas::Page
+{
+	int size;
+	std::unique_ptr<Texture> texture;
+	stbrp_context context;
+	std::vector<stbrp_node> nodes;
+	std::vector<AtlasEntry> entries;
+	size_t usedArea;
+	bool mipsDirty;
+
+	void Reset(int pageSize, const TextureSpec& spec)
+	{
+		size = pageSize;
+		texture = std::make_unique<Texture>(pageSize, pageSize, spec);
+		/* New storage is undefined, space between images would otherwise leak into the mips */
+		std::vector<unsigned char> transparent((size_t)pageSize * pageSize * 4, 0);
+		texture->SetData(0, 0, pageSize, pageSize, transparent.data(), false);
+		mipsDirty = true;
+		nodes.resize(pageSize);
+		stbrp_init_target(&context, pageSize, pageSize, nodes.data(), (int)nodes.size());
+		usedArea = 0;
+	}
+};
+
+TextureAtlas::TextureAtlas(int initialPageSize, int maxPageSize, int padding, const TextureSpec& spec)
+	: m_InitialPageSize(std::min(initialPageSize, maxPageSize)), m_MaxPageSize(maxPageSize), m_Padding(padding), m_Spec(spec)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+}
+
+const SubTexture* TextureAtlas::Add(const std::string& path)
+{
+	if (const SubTexture* existing = Get(path))
+		return existing;
+
+	int width, height, bpp;
+	stbi_set_flip_vertically_on_load(1);
+	unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &bpp, 4);
+	if (!pixels)
+	{
+		std::cout << "Warning: could not load texture '" << path << "'" << std::endl;
+		return nullptr;
+	}
+
+	const SubTexture* subTexture = Add(path, pixels, width, height);
+	stbi_image_free(pixels);
+	return subTexture;
+}
+
+const SubTexture* TextureAtlas::Add(const std::string& name, const unsigned char* pixels, int width, int height)
+{
+	if (const SubTexture* existing = Get(name))
+		return existing;
+
+	if (width + m_Padding * 2 > m_MaxPageSize || height + m_Padding * 2 > m_MaxPageSize)
+	{
+		std::cout << "Warning: '" << name << "' (" << width << "x" << height << ") is larger than an atlas page" << std::endl;
+		return nullptr;
+	}
+
+	SubTexture& subTexture = m_SubTextures[name];
+	subTexture = { nullptr, glm::vec2(0.0f), glm::vec2(0.0f), width, height };
+
+	/* Newest page first, older ones are usually full */
+	for (auto it = m_Pages.rbegin(); it != m_Pages.rend(); ++it)
+	{
+		if (Insert(**it, subTexture, pixels, width, height) || Grow(**it, subTexture, pixels, width, height))
+			return &subTexture;
+	}
+
+	m_Pages.push_back(std::make_unique<Page>());
+	Page& page = *m_Pages.back();
+	page.Reset(m_InitialPageSize, m_Spec);
+	if (Insert(page, subTexture, pixels, width, height) || Grow(page, subTexture, pixels, width, height))
+		return &subTexture;
+
+	m_SubTextures.erase(name);
+	return nullptr;
+}
+
+const SubTexture* TextureAtlas::Get(const std::string& name) const
+{
+	auto it = m_SubTextures.find(name);
+	return it == m_SubTextures.end() ? nullptr : &it->second;
+}
+
+unsigned int TextureAtlas::GetPageCount() const
+{
+	return (unsigned int)m_Pages.size();
+}
+
+const Texture& TextureAtlas::GetPage(unsigned int index) const
+{
+	return *m_Pages[index]->texture;
+}
+
+float TextureAtlas::GetPageOccupancy(unsigned int index) const
+{
+	const Page& page = *m_Pages[index];
+	return (float)page.usedArea / ((float)page.size * page.size);
+}
+
+/* Pack one more rectangle into the page's skyline, the existing ones don't move */
+bool TextureAtlas::Insert(Page& page, SubTexture& subTexture, const unsigned char* pixels, int width, int height)
+{
+	stbrp_rect rect = {};
+	rect.w = width + m_Padding * 2;
+	rect.h = height + m_Padding * 2;
+	if (!stbrp_pack_rects(&page.context, &rect, 1))
+		return false;
+
+	AtlasEntry entry = { &subTexture, std::vector<unsigned char>(pixels, pixels + (size_t)width * height * 4), rect.x + m_Padding, rect.y + m_Padding };
+	Upload(page, entry);
+	page.entries.push_back(std::move(entry));
+	page.usedArea += (size_t)rect.w * rect.h;
+
+	UpdateUVs(page);
+	return true;
+}
+
+/* Repack everything on the page, plus the new image, into the smallest doubled size that fits */
+bool TextureAtlas::Grow(Page& page, SubTexture& subTexture, const unsigned char* pixels, int width, int height)
+{
+	std::vector<stbrp_rect> rects(page.entries.size() + 1);
+	for (size_t i = 0; i < page.entries.size(); i++)
+	{
+		rects[i].id = (int)i;
+		rects[i].w = page.entries[i].subTexture->Width + m_Padding * 2;
+		rects[i].h = page.entries[i].subTexture->Height + m_Padding * 2;
+	}
+	rects.back().id = (int)page.entries.size();
+	rects.back().w = width + m_Padding * 2;
+	rects.back().h = height + m_Padding * 2;
+
+	/* Packing is deterministic, so a trial run on a scratch context tells whether a size works
+	   without touching the page */
+	int newSize = page.size;
+	bool fits = false;
+	while (!fits && newSize < m_MaxPageSize)
+	{
+		newSize = std::min(newSize * 2, m_MaxPageSize);
+
+		stbrp_context context;
+		std::vector<stbrp_node> nodes(newSize);
+		stbrp_init_target(&context, newSize, newSize, nodes.data(), (int)nodes.size());
+		fits = stbrp_pack_rects(&context, rects.data(), (int)rects.size()) != 0;
+	}
+	if (!fits)
+		return false;
+
+	std::vector<AtlasEntry> entries = std::move(page.entries);
+	entries.push_back({ &subTexture, std::vector<unsigned char>(pixels, pixels + (size_t)width * height * 4), 0, 0 });
+
+	page.Reset(newSize, m_Spec);
+	stbrp_pack_rects(&page.context, rects.data(), (int)rects.size());
+	for (const stbrp_rect& rect : rects)
+	{
+		AtlasEntry& entry = entries[rect.id];
+		entry.x = rect.x + m_Padding;
+		entry.y = rect.y + m_Padding;
+		Upload(page, entry);
+		page.usedArea += (size_t)rect.w * rect.h;
+	}
+	page.entries = std::move(entries);
+
+	UpdateUVs(page);
+	return true;
+}
+
+void TextureAtlas::Flush()
+{
+	for (auto& page : m_Pages)
+	{
+		if (page->mipsDirty)
+			page->texture->GenerateMips();
+		page->mipsDirty = false;
+	}
+}
+
+void TextureAtlas::Upload(Page& page, const AtlasEntry& entry)
+{
+	int width = entry.subTexture->Width, height = entry.subTexture->Height;
+	int paddedWidth = width + m_Padding * 2, paddedHeight = height + m_Padding * 2;
+
+	std::vector<unsigned char> padded((size_t)paddedWidth * paddedHeight * 4);
+	for (int y = 0; y < paddedHeight; y++)
+	{
+		const unsigned char* source = &entry.pixels[(size_t)glm::clamp(y - m_Padding, 0, height - 1) * width * 4];
+		unsigned char* row = &padded[(size_t)y * paddedWidth * 4];
+		for (int x = 0; x < m_Padding; x++)
+		{
+			memcpy(row + x * 4, source, 4);
+			memcpy(row + (m_Padding + width + x) * 4, source + (width - 1) * 4, 4);
+		}
+		memcpy(row + m_Padding * 4, source, (size_t)width * 4);
+	}
+
+	page.texture->SetData(entry.x - m_Padding, entry.y - m_Padding, paddedWidth, paddedHeight, padded.data(), false);
+	page.mipsDirty = true;
+}
+
+void TextureAtlas::UpdateUVs(Page& page)
+{
+	float size = (float)page.size;
+	for (const AtlasEntry& entry : page.entries)
+	{
+		SubTexture& subTexture = *entry.subTexture;
+		subTexture.Page = page.texture.get();
+		subTexture.UVMin = glm::vec2(entry.x / size, entry.y / size);
+		subTexture.UVMax = glm::vec2((entry.x + subTexture.Width) / size, (entry.y + subTexture.Height) / size);
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Texture.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+/* An image packed into an atlas page. Pointers handed out by TextureAtlas stay valid,
+   and Page/UV are updated in place when the page grows */
+struct SubTexture
+{
+	const Texture* Page;
+	glm::vec2 UVMin, UVMax;
+	int Width, Height;
+};
+
+/* Packs many small RGBA8 images into a few large page textures with stb_rect_pack,
+   so a whole scene of sprites can be drawn with a single texture bound.
+   A full page is repacked at twice its size, up to maxPageSize, before a new page is started */
+class TextureAtlas
+{
+private:
+	struct Page;
+	struct AtlasEntry;
+
+	int m_InitialPageSize, m_MaxPageSize;
+	int m_Padding;
+	TextureSpec m_Spec;
+
+	std::vector<std::unique_ptr<Page>> m_Pages;
+	std::unordered_map<std::string, SubTexture> m_SubTextures;
+
+public:
+	TextureAtlas(int initialPageSize = 512, int maxPageSize = 2048, int padding = 1, const TextureSpec& spec = TextureSpec());
+	~TextureAtlas();
+
+	/* Decode with stb_image and pack under the file's path. Adding the same name twice
+	   returns the existing entry. Returns nullptr when the image can't be loaded or doesn't fit a page */
+	const SubTexture* Add(const std::string& path);
+	const SubTexture* Add(const std::string& name, const unsigned char* pixels, int width, int height);
+
+	const SubTexture* Get(const std::string& name) const;
+
+	unsigned int GetPageCount() const;
+	const Texture& GetPage(unsigned int index) const;
+
+	/* Fraction of the page area covered by images, padding included */
+	float GetPageOccupancy(unsigned int index) const;
+
+	/* Add only writes level 0, call this once after a batch of Adds to rebuild the mip
+	   levels of every page that changed. Without mips it does nothing */
+	void Flush();
+
+private:
+	bool Insert(Page& page, SubTexture& subTexture, const unsigned char* pixels, int width, int height);
+	bool Grow(Page& page, SubTexture& subTexture, const unsigned char* pixels, int width, int height);
+	/* Writes the image with its edge pixels repeated out into the padding, so filtering at
+	   the border of a sub-texture never picks up its neighbours */
+	void Upload(Page& page, const AtlasEntry& entry);
+	void UpdateUVs(Page& page);
+};
@@ -0,0 +1,173 @@
+#include "TextureLoader.h"
+
+#include "StateCache.h"
+#include "CpuProfiler.h"
+
+#include "stb_image/stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+TextureLoader::TextureLoader(unsigned int threadCount, unsigned int uploadBudget)
+	: m_Stopping(false), m_PixelBuffer(0), m_UploadBudget(uploadBudget), m_PendingCount(0)
+{
+	/* The flip flag is global in this stb_image version, so set it before any worker reads it */
+	stbi_set_flip_vertically_on_load(1);
+
+	if (threadCount == 0)
+	{
+		/* hardware_concurrency is allowed to return 0 when it can't tell */
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+	for (unsigned int i = 0; i < threadCount; i++)
+		m_Workers.emplace_back(&TextureLoader::WorkerThread, this);
+
+	GLCall(glGenBuffers(1, &m_PixelBuffer));
+}
+
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_WorkAvailable.notify_all();
+	for (std::thread& worker : m_Workers)
+		worker.join();
+
+	/* Drop whatever didn't finish, the textures keep their placeholder */
+	for (Job& job : m_Decoded)
+		stbi_image_free(job.pixels);
+	for (Job& job : m_Uploads)
+	{
+		stbi_image_free(job.pixels);
+		if (job.rendererID)
+		{
+			GLCall(glDeleteTextures(1, &job.rendererID));
+			StateCache::Get().OnTextureDeleted(job.rendererID);
+		}
+	}
+
+	GLCall(glDeleteBuffers(1, &m_PixelBuffer));
+}
+
+std::shared_ptr<Texture> TextureLoader::Load(const std::string& path, const TextureSpec& spec)
+{
+	std::shared_ptr<Texture> texture(new Texture(path, spec, Texture::PlaceholderTag()));
+
+	Job job;
+	job.texture = texture;
+	job.pixels = nullptr;
+	job.width = job.height = 0;
+	job.rendererID = 0;
+	job.level = 0;
+	job.uploadedRows = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Decode.push_back(std::move(job));
+	}
+	m_WorkAvailable.notify_one();
+	m_PendingCount++;
+	return texture;
+}
+
+void TextureLoader::WorkerThread()
+{
+	CpuProfiler::SetThreadName("Texture loader");
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WorkAvailable.wait(lock, [this] { return m_Stopping || !m_Decode.empty(); });
+			if (m_Stopping)
+				return;
+			job = std::move(m_Decode.front());
+			m_Decode.pop_front();
+		}
+
+		CPU_PROFILE_SCOPE("TextureLoader decode");
+		int bpp;
+		job.pixels = stbi_load(job.texture->GetFilePath().c_str(), &job.width, &job.height, &bpp, 4);
+		if (job.pixels)
+		{
+			unsigned int levels = Texture::GetMipLevels(job.texture->GetSpec(), job.width, job.height);
+			job.levels = BuildMipChain(job.pixels, job.width, job.height, levels, job.mipStorage);
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Decoded.push_back(std::move(job));
+	}
+}
+
+void TextureLoader::Update()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (Job& job : m_Decoded)
+			m_Uploads.push_back(std::move(job));
+		m_Decoded.clear();
+	}
+
+	/* UploadRows always sends at least one row, so a row bigger than the budget still gets through */
+	unsigned int budget = m_UploadBudget;
+	while (!m_Uploads.empty() && budget > 0)
+	{
+		Job& job = m_Uploads.front();
+		if (!job.pixels)
+		{
+			std::cout << "Warning: could not load texture '" << job.texture->GetFilePath() << "'" << std::endl;
+			m_Uploads.pop_front();
+			m_PendingCount--;
+			continue;
+		}
+
+		unsigned int sent = UploadRows(job, budget);
+		budget -= std::min(budget, sent);
+
+		if (job.level == job.levels.size())
+		{
+			stbi_image_free(job.pixels);
+			job.texture->Replace(job.rendererID, job.width, job.height);
+			m_Uploads.pop_front();
+			m_PendingCount--;
+		}
+	}
+}
+
+unsigned int TextureLoader::UploadRows(Job& job, unsigned int budget)
+{
+	const MipLevel& level = job.levels[job.level];
+	unsigned int rowSize = level.Width * 4;
+	int rows = std::min(level.Height - job.uploadedRows, std::max(1, (int)(budget / rowSize)));
+	unsigned int size = rows * rowSize;
+
+	/* Storage is allocated on the first chunk, the placeholder stays bound until the last one */
+	if (job.rendererID == 0)
+		job.rendererID = Texture::CreateStorage(job.width, job.height, nullptr, job.texture->GetSpec());
+
+	/* Reallocating the store each chunk lets the driver hand back fresh memory
+	   instead of waiting for the previous glTexSubImage2D to read it */
+	GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_PixelBuffer));
+	GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+	GLCall(void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+	memcpy(mapped, level.Pixels + (size_t)job.uploadedRows * rowSize, size);
+	GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+	StateCache::Get().BindTexture2D(0, job.rendererID);
+	GLCall(glTexSubImage2D(GL_TEXTURE_2D, job.level, 0, job.uploadedRows, level.Width, rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	StateCache::Get().BindTexture2D(0, 0);
+
+	/* Leaving it bound would turn every later pixel upload (e.g. ImGui's font) into a PBO read */
+	GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+
+	job.uploadedRows += rows;
+	if (job.uploadedRows == level.Height)
+	{
+		job.level++;
+		job.uploadedRows = 0;
+	}
+	return size;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Texture.h"
+#include "MipChain.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Decodes images with stb_image on worker threads and uploads them on the render
+   thread through a pixel buffer object, a bounded number of bytes per frame.
+   Load returns straight away with a texture showing a 1x1 placeholder.
+   Mip levels are box filtered on the worker instead of with glGenerateMipmap */
+class TextureLoader
+{
+private:
+	/* Moved between the queues, never copied, since levels point into mipStorage */
+	struct Job
+	{
+		std::shared_ptr<Texture> texture;
+		unsigned char* pixels;
+		int width, height;
+		std::vector<unsigned char> mipStorage;
+		std::vector<MipLevel> levels;
+
+		/* Render thread upload progress */
+		unsigned int rendererID;
+		unsigned int level;
+		int uploadedRows;
+	};
+
+	std::vector<std::thread> m_Workers;
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkAvailable;
+	bool m_Stopping;
+
+	/* Guarded by m_Mutex */
+	std::deque<Job> m_Decode;
+	std::deque<Job> m_Decoded;
+
+	/* Render thread only */
+	std::deque<Job> m_Uploads;
+	unsigned int m_PixelBuffer;
+	unsigned int m_UploadBudget;
+	unsigned int m_PendingCount;
+
+public:
+	/* threadCount 0 picks one less than the number of hardware threads */
+	TextureLoader(unsigned int threadCount = 0, unsigned int uploadBudget = 4 * 1024 * 1024);
+	~TextureLoader();
+
+	std::shared_ptr<Texture> Load(const std::string& path, const TextureSpec& spec = TextureSpec());
+
+	/* Call once per frame on the render thread, uploads at most the budget in bytes */
+	void Update();
+
+	inline void SetUploadBudget(unsigned int bytes) { m_UploadBudget = bytes; }
+	inline unsigned int GetUploadBudget() const { return m_UploadBudget; }
+	inline unsigned int GetPendingCount() const { return m_PendingCount; }
+	inline unsigned int GetThreadCount() const { return (unsigned int)m_Workers.size(); }
+
+private:
+	void WorkerThread();
+	/* Returns the number of bytes sent */
+	unsigned int UploadRows(Job& job, unsigned int budget);
+};
@@ -0,0 +1,27 @@
+#include "UniformBuffer.h"
+
+#include "Renderer.h"
+
+UniformBuffer::UniformBuffer(const UniformBufferLayout& layout, unsigned int binding)
+	: m_RendererID(0), m_Binding(binding), m_Data(layout.GetSize(), 0), m_Dirty(true)
+{
+	GLCall(glGenBuffers(1, &m_RendererID));
+	GLCall(glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID));
+	GLCall(glBufferData(GL_UNIFORM_BUFFER, m_Data.size(), nullptr, GL_DYNAMIC_DRAW));
+	GLCall(glBindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID));
+}
+
+UniformBuffer::~UniformBuffer()
+{
+	GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void UniformBuffer::Upload()
+{
+	if (!m_Dirty)
+		return;
+
+	GLCall(glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID));
+	GLCall(glBufferSubData(GL_UNIFORM_BUFFER, 0, m_Data.size(), m_Data.data()));
+	m_Dirty = false;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+/* std140 base alignment and size of the types a uniform block member can have */
+template<typename T> struct Std140;
+template<> struct Std140<float>		{ static const unsigned int Alignment = 4;	static const unsigned int Size = 4; };
+template<> struct Std140<int>		{ static const unsigned int Alignment = 4;	static const unsigned int Size = 4; };
+template<> struct Std140<glm::vec2>	{ static const unsigned int Alignment = 8;	static const unsigned int Size = 8; };
+template<> struct Std140<glm::vec3>	{ static const unsigned int Alignment = 16;	static const unsigned int Size = 12; };
+template<> struct Std140<glm::vec4>	{ static const unsigned int Alignment = 16;	static const unsigned int Size = 16; };
+template<> struct Std140<glm::mat4>	{ static const unsigned int Alignment = 16;	static const unsigned int Size = 64; };
+
+/* Computes member offsets of a std140 uniform block, push members in declaration order */
+class UniformBufferLayout
+{
+private:
+	unsigned int m_Size;
+
+public:
+	UniformBufferLayout()
+		: m_Size(0) {}
+
+	template<typename T>
+	unsigned int Push()
+	{
+		unsigned int offset = (m_Size + Std140<T>::Alignment - 1) & ~(Std140<T>::Alignment - 1);
+		m_Size = offset + Std140<T>::Size;
+		return offset;
+	}
+
+	/* The block as a whole is padded to the alignment of a vec4 */
+	inline unsigned int GetSize() const { return (m_Size + 15) & ~15u; }
+};
+
+/* Uniform block storage bound to a fixed binding point. Members are staged on
+   the CPU and sent with a single glBufferSubData by Upload */
+class UniformBuffer
+{
+public:
+	/* Binding point of the per-frame Camera block, Shader hooks it up at link time */
+	static const unsigned int CameraBinding = 0;
+
+private:
+	unsigned int m_RendererID;
+	unsigned int m_Binding;
+	std::vector<unsigned char> m_Data;
+	bool m_Dirty;
+
+public:
+	UniformBuffer(const UniformBufferLayout& layout, unsigned int binding);
+	~UniformBuffer();
+
+	template<typename T>
+	void Set(unsigned int offset, const T& value)
+	{
+		memcpy(m_Data.data() + offset, &value, Std140<T>::Size);
+		m_Dirty = true;
+	}
+
+	/* Send the staged data if anything changed since the last upload */
+	void Upload();
+
+	inline unsigned int GetBinding() const { return m_Binding; }
+};
@@ -2,37 +2,59 @@
 
 #include "VertexBufferLayout.h"
 #include "Renderer.h"
+#include "StateCache.h"
 
 VertexArray::VertexArray()
+	: m_AttribIndex(0)
 {
 	GLCall(glGenVertexArrays(1, &m_RendererID));
 }
 
 VertexArray::~VertexArray()
 {
+	GLCall(glDeleteVertexArrays(1, &m_RendererID));
+	StateCache::Get().OnVertexArrayDeleted(m_RendererID);
 }
 
 void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
 {
 	Bind();
 	vb.Bind();
+	SetLayout(layout);
+}
+
+void VertexArray::AddBuffer(const StreamingVertexBuffer& vb, const VertexBufferLayout& layout)
+{
+	Bind();
+	vb.Bind();
+	SetLayout(layout);
+}
+
+/* Point the attributes at the currently bound GL_ARRAY_BUFFER */
+void VertexArray::SetLayout(const VertexBufferLayout& layout)
+{
 	const auto& elements = layout.GetElements();
 	unsigned int offset = 0;
 	for (unsigned int i = 0; i < elements.size(); i++)
 	{
 		const auto& element = elements[i];
-		GLCall(glEnableVertexAttribArray(i));
-		GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*) offset));
+		unsigned int index = m_AttribIndex++;
+		GLCall(glEnableVertexAttribArray(index));
+		GLCall(glVertexAttribPointer(index, element.count, element.type, element.normalized, layout.GetStride(), (const void*) offset));
+		if (layout.GetDivisor())
+		{
+			GLCall(glVertexAttribDivisor(index, layout.GetDivisor()));
+		}
 		offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
 	}
 }
 
 void VertexArray::Bind() const
 {
-	GLCall(glBindVertexArray(m_RendererID));
+	StateCache::Get().BindVertexArray(m_RendererID);
 }
 
 void VertexArray::Unbind() const
 {
-	GLCall(glBindVertexArray(0));
+	StateCache::Get().BindVertexArray(0);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "VertexBuffer.h"
+#include "StreamingVertexBuffer.h"
 
 class VertexBufferLayout;
 
@@ -8,12 +9,18 @@ class VertexArray
 {
 private:
 	unsigned int m_RendererID;
+	/* Next free attribute location, so several buffers can feed one VAO */
+	unsigned int m_AttribIndex;
 public:
 	VertexArray();
 	~VertexArray();
 	
 	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+	void AddBuffer(const StreamingVertexBuffer& vb, const VertexBufferLayout& layout);
 
 	void Bind() const;
 	void Unbind() const;
+
+private:
+	void SetLayout(const VertexBufferLayout& layout);
 };
\ No newline at end of file
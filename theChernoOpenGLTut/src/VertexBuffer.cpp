@@ -1,25 +1,41 @@
 #include "VertexBuffer.h"
 
 #include "Renderer.h"
+#include "StateCache.h"
 
 VertexBuffer::VertexBuffer(const void* data, unsigned int size)
 {
 	GLCall(glGenBuffers(1, &m_RendererID));
-	GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+	StateCache::Get().BindArrayBuffer(m_RendererID);
 	GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
 }
 
+/* Allocate an empty buffer to be filled every frame with SetData */
+VertexBuffer::VertexBuffer(unsigned int size)
+{
+	GLCall(glGenBuffers(1, &m_RendererID));
+	StateCache::Get().BindArrayBuffer(m_RendererID);
+	GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+}
+
 VertexBuffer::~VertexBuffer()
 {
 	GLCall(glDeleteBuffers(1, &m_RendererID));
+	StateCache::Get().OnBufferDeleted(m_RendererID);
+}
+
+void VertexBuffer::SetData(const void* data, unsigned int size)
+{
+	Bind();
+	GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
 }
 
 void VertexBuffer::Bind() const
 {
-	GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+	StateCache::Get().BindArrayBuffer(m_RendererID);
 }
 
 void VertexBuffer::Unbind() const
 {
-	GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+	StateCache::Get().BindArrayBuffer(0);
 }
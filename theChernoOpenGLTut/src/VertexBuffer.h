@@ -7,8 +7,11 @@ private:
 
 public:
 	VertexBuffer(const void* data, unsigned int size);
+	VertexBuffer(unsigned int size);
 	~VertexBuffer();
 
+	void SetData(const void* data, unsigned int size);
+
 	void Bind() const;
 	void Unbind() const;
 };
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <vector>
 #include "Renderer.h"
 
+#include "glm/glm.hpp"
+
 struct VertexBufferElement
 {
 	unsigned int 
@@ -28,10 +30,13 @@ class VertexBufferLayout
 private:
 	std::vector<VertexBufferElement> m_Elements;
 	unsigned int m_Stride;
+	unsigned int m_Divisor;
 
 public:
-	VertexBufferLayout()
-		: m_Stride(0) {}
+	/* A non-zero divisor makes this a per-instance stream that
+	   advances once every divisor instances instead of every vertex */
+	VertexBufferLayout(unsigned int divisor = 0)
+		: m_Stride(0), m_Divisor(divisor) {}
 
 	template<typename T>
 	void Push(unsigned int count)
@@ -60,6 +65,16 @@ public:
 		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
 	}
 
+	template<>
+	void Push<glm::mat4>(unsigned int count)
+	{
+		/* A mat4 attribute takes up four consecutive locations, one per column */
+		for (unsigned int i = 0; i < count * 4; i++)
+			m_Elements.push_back({ GL_FLOAT, 4, GL_FALSE });
+		m_Stride += count * 16 * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+	}
+
 	inline const std::vector<VertexBufferElement> GetElements() const { return m_Elements; }
 	inline unsigned int GetStride() const { return m_Stride; }
+	inline unsigned int GetDivisor() const { return m_Divisor; }
 };
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "BenchmarkRunner.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "Framebuffer.h"
+#include "CpuProfiler.h"
+#include "FrameTimer.h"
+
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace test
+{
+	BenchmarkRunner::BenchmarkRunner(const TestMenu& menu, Framebuffer& target, const BenchmarkSettings& settings)
+		: m_Menu(menu), m_Target(target), m_Settings(settings)
+	{
+	}
+
+	bool BenchmarkRunner::Run(const std::string& testName, const FrameCallback& onFrame)
+	{
+		m_TestName = testName;
+		m_Frames.clear();
+
+		std::unique_ptr<Test> test(m_Menu.CreateTest(testName));
+		if (!test)
+			return false;
+
+		int totalFrames = m_Settings.WarmupFrames + m_Settings.MeasuredFrames;
+		std::vector<BenchmarkFrame> frames(totalFrames);
+
+		/* A begin and end timestamp per frame in flight. GL_TIME_ELAPSED would clash with a
+		   test that times part of its own frame, only one of those can be active at once */
+		unsigned int queries[2 * s_QueryCount];
+		GLCall(glGenQueries(2 * s_QueryCount, queries));
+		auto readGpuTime = [&](int frame)
+		{
+			GLuint64 begin = 0, end = 0;
+			GLCall(glGetQueryObjectui64v(queries[2 * (frame % s_QueryCount)], GL_QUERY_RESULT, &begin));
+			GLCall(glGetQueryObjectui64v(queries[2 * (frame % s_QueryCount) + 1], GL_QUERY_RESULT, &end));
+			frames[frame].GpuMilliseconds = (end - begin) / 1.0e6;
+		};
+
+		/* A step the length of a frame, so every frame runs exactly one and nothing is interpolated */
+		FixedTimestep fixedTimestep(m_Settings.DeltaTime);
+
+		Renderer renderer;
+		float width = (float)m_Target.GetWidth(), height = (float)m_Target.GetHeight();
+		ImGui::GetIO().DeltaTime = m_Settings.DeltaTime;
+
+		for (int frame = 0; frame < totalFrames; frame++)
+		{
+			/* The query about to be reused is the one from s_QueryCount frames ago */
+			if (frame >= s_QueryCount)
+				readGpuTime(frame - s_QueryCount);
+
+			CPU_PROFILE_SCOPE("Frame");
+			StateCache::Get().ResetStats();
+			Renderer::ResetStats();
+
+			auto cpuStart = std::chrono::high_resolution_clock::now();
+			GLCall(glQueryCounter(queries[2 * (frame % s_QueryCount)], GL_TIMESTAMP));
+
+			m_Target.Bind();
+			GLCall(glClearColor(0.0f, 0.0f, 0.0f, 0.0f));
+			renderer.Clear();
+			Renderer::BeginFrame(frame * m_Settings.DeltaTime, glm::vec2(width, height));
+
+			ImGui::NewFrame();
+			{
+				CPU_PROFILE_SCOPE("OnUpdate");
+				test->OnUpdate(m_Settings.DeltaTime);
+			}
+			{
+				CPU_PROFILE_SCOPE("OnFixedUpdate");
+				for (int steps = fixedTimestep.Advance(m_Settings.DeltaTime); steps > 0; steps--)
+					test->OnFixedUpdate(fixedTimestep.GetStep());
+				test->OnInterpolate(fixedTimestep.GetAlpha());
+			}
+			{
+				CPU_PROFILE_SCOPE("OnRender");
+				test->OnRender();
+			}
+			{
+				CPU_PROFILE_SCOPE("OnImGuiRender");
+				ImGui::Begin("Test");
+				test->OnImGuiRender();
+				ImGui::End();
+				ImGui::Render();
+			}
+			m_Target.Unbind();
+
+			GLCall(glQueryCounter(queries[2 * (frame % s_QueryCount) + 1], GL_TIMESTAMP));
+			auto cpuEnd = std::chrono::high_resolution_clock::now();
+
+			BenchmarkFrame& result = frames[frame];
+			result.CpuMilliseconds = std::chrono::duration<double, std::milli>(cpuEnd - cpuStart).count();
+			result.DrawCalls = Renderer::GetStats().DrawCalls;
+			result.Triangles = Renderer::GetStats().Triangles;
+			result.BindsIssued = StateCache::Get().GetStats().Issued;
+			result.BindsElided = StateCache::Get().GetStats().Elided;
+
+			if (onFrame && frame >= m_Settings.WarmupFrames)
+				onFrame(frame - m_Settings.WarmupFrames);
+		}
+		for (int frame = std::max(0, totalFrames - s_QueryCount); frame < totalFrames; frame++)
+			readGpuTime(frame);
+		GLCall(glDeleteQueries(2 * s_QueryCount, queries));
+
+		m_Frames.assign(frames.begin() + m_Settings.WarmupFrames, frames.end());
+		return true;
+	}
+
+	BenchmarkStatistic BenchmarkRunner::Summarise(std::vector<double> values)
+	{
+		if (values.empty())
+			return { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+		std::sort(values.begin(), values.end());
+		auto percentile = [&](double p)
+		{
+			size_t rank = (size_t)std::ceil(p / 100.0 * values.size());
+			return values[std::min(values.size(), std::max<size_t>(rank, 1)) - 1];
+		};
+
+		double total = 0.0;
+		for (double value : values)
+			total += value;
+
+		size_t middle = values.size() / 2;
+		double median = values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+		return { values.front(), median, percentile(95.0), percentile(99.0), values.back(), total / values.size() };
+	}
+
+	std::vector<std::pair<const char*, std::vector<double>>> BenchmarkRunner::GetMetrics() const
+	{
+		std::vector<std::pair<const char*, std::vector<double>>> metrics =
+		{
+			{ "cpu_ms", {} }, { "gpu_ms", {} }, { "draw_calls", {} },
+			{ "triangles", {} }, { "binds_issued", {} }, { "binds_elided", {} },
+		};
+		for (const BenchmarkFrame& frame : m_Frames)
+		{
+			metrics[0].second.push_back(frame.CpuMilliseconds);
+			metrics[1].second.push_back(frame.GpuMilliseconds);
+			metrics[2].second.push_back(frame.DrawCalls);
+			metrics[3].second.push_back(frame.Triangles);
+			metrics[4].second.push_back(frame.BindsIssued);
+			metrics[5].second.push_back(frame.BindsElided);
+		}
+		return metrics;
+	}
+
+	static std::string FormatStatistic(const char* format, const BenchmarkStatistic& s)
+	{
+		char buffer[256];
+		std::snprintf(buffer, sizeof(buffer), format, s.Min, s.Median, s.P95, s.P99, s.Max, s.Mean);
+		return buffer;
+	}
+
+	/* Inside a JSON string, the renderer string comes from the driver and can hold anything */
+	static void WriteEscaped(std::ostream& stream, const char* str)
+	{
+		for (; *str; str++)
+		{
+			if (*str == '"' || *str == '\\')
+				stream << '\\';
+			if ((unsigned char)*str >= 0x20)
+				stream << *str;
+		}
+	}
+
+	void BenchmarkRunner::WriteJSON(std::ostream& stream) const
+	{
+		const char* renderer = (const char*)glGetString(GL_RENDERER);
+		stream << "{\n";
+		stream << "\t\"test\": \"";
+		WriteEscaped(stream, m_TestName.c_str());
+		stream << "\",\n";
+		stream << "\t\"renderer\": \"";
+		WriteEscaped(stream, renderer ? renderer : "");
+		stream << "\",\n";
+		stream << "\t\"width\": " << m_Target.GetWidth() << ",\n";
+		stream << "\t\"height\": " << m_Target.GetHeight() << ",\n";
+		stream << "\t\"warmup_frames\": " << m_Settings.WarmupFrames << ",\n";
+		stream << "\t\"frames\": " << m_Frames.size() << ",\n";
+		stream << "\t\"metrics\": {\n";
+
+		std::vector<std::pair<const char*, std::vector<double>>> metrics = GetMetrics();
+		for (size_t i = 0; i < metrics.size(); i++)
+		{
+			stream << "\t\t\"" << metrics[i].first << "\": "
+				<< FormatStatistic("{ \"min\": %.4f, \"median\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f, \"mean\": %.4f }",
+					Summarise(metrics[i].second))
+				<< (i + 1 < metrics.size() ? ",\n" : "\n");
+		}
+		stream << "\t}\n}\n";
+	}
+
+	void BenchmarkRunner::WriteCSV(std::ostream& stream) const
+	{
+		stream << "metric,min,median,p95,p99,max,mean\n";
+		for (const auto& metric : GetMetrics())
+			stream << metric.first << FormatStatistic(",%.4f,%.4f,%.4f,%.4f,%.4f,%.4f", Summarise(metric.second)) << "\n";
+	}
+
+	void BenchmarkRunner::WriteFrameCSV(std::ostream& stream) const
+	{
+		stream << "frame,cpu_ms,gpu_ms,draw_calls,triangles,binds_issued,binds_elided\n";
+		for (size_t i = 0; i < m_Frames.size(); i++)
+		{
+			const BenchmarkFrame& frame = m_Frames[i];
+			char row[160];
+			std::snprintf(row, sizeof(row), "%zu,%.4f,%.4f,%u,%u,%u,%u\n", i, frame.CpuMilliseconds, frame.GpuMilliseconds,
+				frame.DrawCalls, frame.Triangles, frame.BindsIssued, frame.BindsElided);
+			stream << row;
+		}
+	}
+
+	void BenchmarkRunner::PrintSummary(std::ostream& stream) const
+	{
+		stream << m_TestName << ": " << m_Frames.size() << " frames after " << m_Settings.WarmupFrames
+			<< " warmup at " << m_Target.GetWidth() << "x" << m_Target.GetHeight() << "\n";
+		for (const auto& metric : GetMetrics())
+		{
+			char label[32];
+			std::snprintf(label, sizeof(label), "  %-13s", metric.first);
+			stream << label << FormatStatistic("min %10.4f  median %10.4f  p95 %10.4f  p99 %10.4f  max %10.4f",
+				Summarise(metric.second)) << "\n";
+		}
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Test.h"
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Framebuffer;
+
+namespace test
+{
+	struct BenchmarkSettings
+	{
+		/* Run but not recorded, lets shader compiles and first uploads settle */
+		int WarmupFrames = 10;
+		int MeasuredFrames = 100;
+		/* Passed to OnUpdate and used as the fixed timestep, fixed so runs are repeatable */
+		float DeltaTime = 1.0f / 60.0f;
+	};
+
+	/* What one measured frame cost */
+	struct BenchmarkFrame
+	{
+		double CpuMilliseconds;		// submitting the frame, wall clock
+		double GpuMilliseconds;		// between GL_TIMESTAMP queries around the same work
+		unsigned int DrawCalls;
+		unsigned int Triangles;
+		unsigned int BindsIssued;
+		unsigned int BindsElided;
+	};
+
+	struct BenchmarkStatistic
+	{
+		double Min, Median, P95, P99, Max, Mean;
+	};
+
+	/* Runs a registered test unattended into a Framebuffer: warmup, then the measured
+	   frames, collecting timings and Renderer/StateCache counters for every frame.
+	   Needs a current context and an ImGui context, the UI is built but never drawn */
+	class BenchmarkRunner
+	{
+	public:
+		/* Called after every measured frame, outside the timed part, e.g. to capture it */
+		using FrameCallback = std::function<void(int frame)>;
+
+	private:
+		/* Frames of timestamp queries in flight, results are read this many frames late so nothing waits on the GPU */
+		static const int s_QueryCount = 4;
+
+		const TestMenu& m_Menu;
+		Framebuffer& m_Target;
+		BenchmarkSettings m_Settings;
+
+		std::string m_TestName;
+		std::vector<BenchmarkFrame> m_Frames;
+
+	public:
+		BenchmarkRunner(const TestMenu& menu, Framebuffer& target, const BenchmarkSettings& settings = BenchmarkSettings());
+
+		/* False if no test is registered under that name */
+		bool Run(const std::string& testName, const FrameCallback& onFrame = FrameCallback());
+
+		inline const std::vector<BenchmarkFrame>& GetFrames() const { return m_Frames; }
+
+		/* Nearest rank percentiles */
+		static BenchmarkStatistic Summarise(std::vector<double> values);
+
+		/* Every metric's statistics, as one JSON object or as CSV rows of metric,min,median,... */
+		void WriteJSON(std::ostream& stream) const;
+		void WriteCSV(std::ostream& stream) const;
+		/* One CSV row per measured frame */
+		void WriteFrameCSV(std::ostream& stream) const;
+		/* Short human readable version for the console */
+		void PrintSummary(std::ostream& stream) const;
+
+	private:
+		/* Name and value of every column, in output order */
+		std::vector<std::pair<const char*, std::vector<double>>> GetMetrics() const;
+	};
+}
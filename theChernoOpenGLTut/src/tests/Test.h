@@ -13,6 +13,10 @@ namespace test
 		virtual ~Test() {}
 
 		virtual void OnUpdate(float deltaTime) {}
+		/* Zero or more times a frame, after OnUpdate, always with the same timestep */
+		virtual void OnFixedUpdate(float timestep) {}
+		/* How far between the last two fixed steps this frame is drawn, 0..1 */
+		virtual void OnInterpolate(float alpha) {}
 		virtual void OnRender() {}
 		virtual void OnImGuiRender() {}
 	};
@@ -29,6 +33,10 @@ namespace test
 
 		virtual void OnImGuiRender() override;
 
+		/* Look a test up by the name it was registered with, nullptr if there is none */
+		Test* CreateTest(const std::string& name) const;
+		std::vector<std::string> GetTestNames() const;
+
 		template<typename T>
 		void RegisterTest(const std::string& name)
 		{
@@ -0,0 +1,142 @@
+#include "TestAssetPack.h"
+
+#include "Renderer.h"
+#include "Shader.h"
+
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+namespace test
+{
+	static const char* s_PackPath = "cache/res.pak";
+	static const char* s_TexturePath = "res/textures/Sigil.png";
+	static const char* s_ShaderPaths[] = { "res/shaders/Basic.shader", "res/shaders/Batch.shader" };
+
+	static float ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	TestAssetPack::TestAssetPack()
+		:	m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+			m_View(glm::mat4(1.0f)),
+			m_PackedCount(0), m_PackTime(0.0f), m_OpenTime(0.0f),
+			m_LooseShaderTime(0.0f), m_LooseTextureTime(0.0f),
+			m_PackShaderTime(0.0f), m_PackTextureTime(0.0f)
+	{
+		m_BatchRenderer = std::make_unique<BatchRenderer>();
+
+		if (!std::filesystem::exists(s_PackPath))
+			Pack();
+		Load();
+	}
+
+	TestAssetPack::~TestAssetPack()
+	{
+	}
+
+	void TestAssetPack::Pack()
+	{
+		/* The mapping has to go before the file can be rewritten on Windows */
+		m_Pack.reset();
+
+		std::error_code error;
+		std::filesystem::create_directories(std::filesystem::path(s_PackPath).parent_path(), error);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		m_PackedCount = AssetPack::Build("res", s_PackPath);
+		m_PackTime = ElapsedMs(start);
+		if (m_PackedCount < 0)
+			std::cout << "Warning: could not write '" << s_PackPath << "'" << std::endl;
+	}
+
+	void TestAssetPack::Load()
+	{
+		/* Batch.shader needs the define BatchRenderer would inject */
+		ShaderDefines defines;
+		defines["MAX_TEXTURE_SLOTS"] = "16";
+
+		/* Loose files, read and decoded on every load */
+		auto start = std::chrono::high_resolution_clock::now();
+		for (const char* path : s_ShaderPaths)
+			Shader shader(path, defines);
+		m_LooseShaderTime = ElapsedMs(start);
+
+		start = std::chrono::high_resolution_clock::now();
+		m_LooseTexture = std::make_unique<Texture>(s_TexturePath);
+		m_LooseTextureTime = ElapsedMs(start);
+
+		/* Pack, opening it only maps the file, the assets are used in place */
+		m_PackTexture.reset();
+		m_Pack.reset();
+		start = std::chrono::high_resolution_clock::now();
+		m_Pack = std::make_unique<AssetPack>(s_PackPath);
+		m_OpenTime = ElapsedMs(start);
+		if (!m_Pack->IsOpen())
+		{
+			std::cout << "Warning: could not open '" << s_PackPath << "'" << std::endl;
+			return;
+		}
+
+		start = std::chrono::high_resolution_clock::now();
+		ShaderIncludeResolver resolver = m_Pack->GetIncludeResolver();
+		for (const char* path : s_ShaderPaths)
+		{
+			if (const AssetPackEntry* entry = m_Pack->Find(path))
+				Shader shader(path, m_Pack->GetText(*entry), defines, resolver);
+		}
+		m_PackShaderTime = ElapsedMs(start);
+
+		start = std::chrono::high_resolution_clock::now();
+		if (const AssetPackEntry* entry = m_Pack->Find(s_TexturePath))
+		{
+			m_PackTexture = std::make_unique<Texture>(s_TexturePath, m_Pack->GetData(*entry),
+				(int)entry->Width, (int)entry->Height);
+		}
+		m_PackTextureTime = ElapsedMs(start);
+	}
+
+	void TestAssetPack::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		Renderer::SetCamera(m_Proj, m_View);
+		m_BatchRenderer->Begin();
+		m_BatchRenderer->DrawQuad(glm::vec2(250.0f, 270.0f), glm::vec2(400.0f), *m_LooseTexture);
+		if (m_PackTexture)
+			m_BatchRenderer->DrawQuad(glm::vec2(710.0f, 270.0f), glm::vec2(400.0f), *m_PackTexture);
+		m_BatchRenderer->End();
+	}
+
+	void TestAssetPack::OnImGuiRender()
+	{
+		if (ImGui::Button("Repack"))
+		{
+			Pack();
+			Load();
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Reload"))
+			Load();
+
+		if (m_PackTime > 0.0f)
+			ImGui::Text("Packed %d assets in %.1f ms", m_PackedCount, m_PackTime);
+
+		ImGui::Text("Left: loose files, shaders %.2f ms, texture %.2f ms, total %.2f ms",
+			m_LooseShaderTime, m_LooseTextureTime, m_LooseShaderTime + m_LooseTextureTime);
+		if (m_Pack && m_Pack->IsOpen())
+		{
+			ImGui::Text("Right: %s, open %.2f ms, shaders %.2f ms, texture %.2f ms, total %.2f ms", s_PackPath,
+				m_OpenTime, m_PackShaderTime, m_PackTextureTime, m_OpenTime + m_PackShaderTime + m_PackTextureTime);
+			ImGui::Text("%u assets in the index", m_Pack->GetEntryCount());
+		}
+		ImGui::TextWrapped("Offline: assetpack res res.pak");
+	}
+}
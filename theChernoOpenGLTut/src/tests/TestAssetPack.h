@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Test.h"
+
+#include "Texture.h"
+#include "AssetPack.h"
+#include "BatchRenderer.h"
+
+#include <memory>
+
+namespace test
+{
+	/* Packs res/ into cache/res.pak and times loading the same shaders and texture
+	   from loose files against the mapped pack */
+	class TestAssetPack : public Test
+	{
+	private:
+		glm::mat4 m_Proj, m_View;
+
+		std::unique_ptr<AssetPack> m_Pack;
+		std::unique_ptr<Texture> m_LooseTexture;
+		std::unique_ptr<Texture> m_PackTexture;
+		std::unique_ptr<BatchRenderer> m_BatchRenderer;
+
+		int m_PackedCount;
+		float m_PackTime, m_OpenTime;
+		float m_LooseShaderTime, m_LooseTextureTime;
+		float m_PackShaderTime, m_PackTextureTime;
+	public:
+		TestAssetPack();
+		~TestAssetPack();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void Pack();
+		void Load();
+	};
+}
@@ -0,0 +1,110 @@
+#include "TestAtlas.h"
+
+#include "Renderer.h"
+
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cmath>
+#include <string>
+
+namespace test
+{
+	Atlas::Atlas()
+		:	m_UseAtlas(true), m_Seed(1),
+			m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+			m_View(glm::mat4(1.0f)),
+			m_DrawCalls(0)
+	{
+		m_Atlas = std::make_unique<TextureAtlas>();
+		m_BatchRenderer = std::make_unique<BatchRenderer>();
+		AddSprites(200);
+	}
+
+	Atlas::~Atlas()
+	{
+	}
+
+	/* Soft coloured discs of random sizes, added to both the atlas and their own textures */
+	void Atlas::AddSprites(int count)
+	{
+		std::vector<unsigned char> pixels;
+		for (int n = 0; n < count; n++)
+		{
+			m_Seed = m_Seed * 1664525u + 1013904223u;
+			int size = 8 + (m_Seed >> 8) % 89;
+			glm::vec3 colour(((m_Seed >> 4) & 0xFF) / 255.0f, ((m_Seed >> 12) & 0xFF) / 255.0f, ((m_Seed >> 20) & 0xFF) / 255.0f);
+
+			pixels.resize((size_t)size * size * 4);
+			float radius = size * 0.5f;
+			for (int y = 0; y < size; y++)
+			{
+				for (int x = 0; x < size; x++)
+				{
+					float distance = std::sqrt((x + 0.5f - radius) * (x + 0.5f - radius) + (y + 0.5f - radius) * (y + 0.5f - radius));
+					float alpha = glm::clamp(radius - distance, 0.0f, 1.0f);
+					unsigned char* pixel = &pixels[((size_t)y * size + x) * 4];
+					pixel[0] = (unsigned char)(colour.r * 255.0f);
+					pixel[1] = (unsigned char)(colour.g * 255.0f);
+					pixel[2] = (unsigned char)(colour.b * 255.0f);
+					pixel[3] = (unsigned char)(alpha * 255.0f);
+				}
+			}
+
+			std::string name = "sprite" + std::to_string(m_Sprites.size());
+			m_AtlasSprites.push_back(m_Atlas->Add(name, pixels.data(), size, size));
+
+			m_Sprites.push_back(std::make_unique<Texture>(size, size));
+			m_Sprites.back()->SetData(0, 0, size, size, pixels.data());
+		}
+		m_Atlas->Flush();
+	}
+
+	void Atlas::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		int columns = (int)std::ceil(std::sqrt(m_Sprites.size() * 960.0f / 540.0f));
+		float cell = 960.0f / columns;
+
+		Renderer::SetCamera(m_Proj, m_View);
+		m_BatchRenderer->ResetStats();
+		m_BatchRenderer->Begin();
+		for (size_t i = 0; i < m_Sprites.size(); i++)
+		{
+			glm::vec2 position((i % columns + 0.5f) * cell, (i / columns + 0.5f) * cell);
+			if (m_UseAtlas && m_AtlasSprites[i])
+			{
+				const SubTexture& sprite = *m_AtlasSprites[i];
+				float scale = std::min(cell / sprite.Width, 1.0f);
+				m_BatchRenderer->DrawQuad(position, glm::vec2(sprite.Width * scale, sprite.Height * scale), sprite);
+			}
+			else
+			{
+				const Texture& sprite = *m_Sprites[i];
+				float scale = std::min(cell / sprite.GetWidth(), 1.0f);
+				m_BatchRenderer->DrawQuad(position, glm::vec2(sprite.GetWidth() * scale, sprite.GetHeight() * scale), sprite);
+			}
+		}
+		m_BatchRenderer->End();
+		m_DrawCalls = m_BatchRenderer->GetStats().DrawCalls;
+	}
+
+	void Atlas::OnImGuiRender()
+	{
+		ImGui::Checkbox("Use atlas", &m_UseAtlas);
+		if (ImGui::Button("Add 100 sprites"))
+			AddSprites(100);
+
+		ImGui::Text("Sprites: %u, draw calls: %u", (unsigned int)m_Sprites.size(), m_DrawCalls);
+		for (unsigned int i = 0; i < m_Atlas->GetPageCount(); i++)
+		{
+			const Texture& page = m_Atlas->GetPage(i);
+			ImGui::Text("Page %u: %dx%d, %.0f%% used", i, page.GetWidth(), page.GetHeight(), m_Atlas->GetPageOccupancy(i) * 100.0f);
+		}
+		ImGui::Text("Application Average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Test.h"
+
+#include "Texture.h"
+#include "TextureAtlas.h"
+#include "BatchRenderer.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	/* Generates sprites of random sizes and draws them either from their own textures
+	   or from a TextureAtlas, comparing the draw calls each needs */
+	class Atlas : public Test
+	{
+	private:
+		bool m_UseAtlas;
+		unsigned int m_Seed;
+		glm::mat4 m_Proj, m_View;
+
+		std::unique_ptr<TextureAtlas> m_Atlas;
+		std::vector<const SubTexture*> m_AtlasSprites;
+		std::vector<std::unique_ptr<Texture>> m_Sprites;
+		std::unique_ptr<BatchRenderer> m_BatchRenderer;
+
+		unsigned int m_DrawCalls;
+	public:
+		Atlas();
+		~Atlas();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void AddSprites(int count);
+	};
+}
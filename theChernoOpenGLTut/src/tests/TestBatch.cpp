@@ -0,0 +1,125 @@
+#include "TestBatch.h"
+
+#include "Renderer.h"
+
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+#include <cmath>
+
+namespace test
+{
+	Batch::Batch()
+		:	m_QuadCount(1000), m_TextureCount(1), m_Batched(true),
+			m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+			m_View(glm::mat4(1.0f)),
+			m_SubmitTime(0.0f), m_DrawCalls(0)
+	{
+		/* Unit quad for the per-quad path, scaled by the model matrix */
+		float quadData[] =
+		{
+			-0.5f, -0.5f, 0.0f, 0.0f,
+			 0.5f, -0.5f, 1.0f, 0.0f,
+			 0.5f,  0.5f, 1.0f, 1.0f,
+			-0.5f,  0.5f, 0.0f, 1.0f,
+		};
+
+		unsigned int quadIndex[] =
+		{
+			0, 1, 2,		// triangle 1
+			2, 3, 0,		// triangle 2
+		};
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(quadData, 4 * 4 * sizeof(float));
+
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VAO->AddBuffer(*m_VBO, layout);
+
+		m_IBO = std::make_unique<IndexBuffer>(quadIndex, 6);
+
+		m_Shader = std::make_unique<Shader>("res/shaders/Basic.shader");
+		m_Shader->Bind();
+		m_Shader->SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+		m_Shader->SetUniform1i("u_Texture", 0);
+		m_ModelUniform = m_Shader->GetUniform<glm::mat4>(HashString("u_Model"));
+
+		m_BatchRenderer = std::make_unique<BatchRenderer>();
+
+		/* Separate GL textures standing in for different sprite sheets */
+		for (unsigned int i = 0; i < BatchRenderer::MaxTextureSlots; i++)
+			m_Textures.push_back(std::make_unique<Texture>("res/textures/Sigil.png"));
+	}
+
+	Batch::~Batch()
+	{
+	}
+
+	void Batch::OnUpdate(float deltaTime)
+	{
+	}
+
+	void Batch::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		/* Lay the quads out in a grid that covers the window */
+		int columns = (int)std::ceil(std::sqrt(m_QuadCount * 960.0f / 540.0f));
+		float size = 960.0f / columns;
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		Renderer::SetCamera(m_Proj, m_View);
+
+		if (m_Batched)
+		{
+			m_BatchRenderer->ResetStats();
+			m_BatchRenderer->Begin();
+			for (int i = 0; i < m_QuadCount; i++)
+			{
+				glm::vec2 position((i % columns + 0.5f) * size, (i / columns + 0.5f) * size);
+				m_BatchRenderer->DrawQuad(position, glm::vec2(size), *m_Textures[i % m_TextureCount]);
+			}
+			m_BatchRenderer->End();
+			m_DrawCalls = m_BatchRenderer->GetStats().DrawCalls;
+		}
+		else
+		{
+			Renderer renderer;
+			for (int i = 0; i < m_QuadCount; i++)
+			{
+				glm::vec3 position((i % columns + 0.5f) * size, (i / columns + 0.5f) * size, 0.0f);
+				glm::mat4 model = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), glm::vec3(size, size, 1.0f));
+				m_Textures[i % m_TextureCount]->Bind();
+				m_Shader->Bind();
+				m_Shader->SetUniform(m_ModelUniform, model);
+				renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
+			}
+			m_DrawCalls = m_QuadCount;
+		}
+
+		/* Smooth the submission time so the readout is stable */
+		auto end = std::chrono::high_resolution_clock::now();
+		float elapsed = std::chrono::duration<float, std::milli>(end - start).count();
+		m_SubmitTime = m_SubmitTime * 0.95f + elapsed * 0.05f;
+	}
+
+	void Batch::OnImGuiRender()
+	{
+		ImGui::SliderInt("Quads", &m_QuadCount, 1, 50000);
+		ImGui::SliderInt("Textures", &m_TextureCount, 1, (int)m_Textures.size());
+		ImGui::Checkbox("Batched", &m_Batched);
+		ImGui::Text("Texture slots per batch: %u", m_BatchRenderer->GetMaxTextureSlots());
+		ImGui::Text("Vertex streaming: %s", m_BatchRenderer->IsPersistentMapped() ? "persistent mapped" : "unsynchronized map");
+		ImGui::Text("Draw calls: %u", m_DrawCalls);
+		ImGui::Text("CPU submit %.3f ms (%.0f quads/sec submitted)", m_SubmitTime, m_SubmitTime > 0.0f ? m_QuadCount * 1000.0f / m_SubmitTime : 0.0f);
+		ImGui::Text("Frame throughput %.0f quads/sec", m_QuadCount * ImGui::GetIO().Framerate);
+		ImGui::Text("Application Average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
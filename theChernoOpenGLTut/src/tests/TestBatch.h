@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Test.h"
+
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "Texture.h"
+#include "BatchRenderer.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	/* Draws a grid of sprites either one Renderer::Draw per quad or through the BatchRenderer */
+	class Batch : public Test
+	{
+	private:
+		int m_QuadCount;
+		int m_TextureCount;
+		bool m_Batched;
+		glm::mat4 m_Proj, m_View;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		std::unique_ptr<Shader> m_Shader;
+		UniformHandle<glm::mat4> m_ModelUniform;
+		std::vector<std::unique_ptr<Texture>> m_Textures;
+		std::unique_ptr<BatchRenderer> m_BatchRenderer;
+
+		float m_SubmitTime;
+		unsigned int m_DrawCalls;
+	public:
+		Batch();
+		~Batch();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+	};
+}
@@ -0,0 +1,109 @@
+#include "TestCompressedTextures.h"
+
+#include "Renderer.h"
+#include "CompressedImage.h"
+
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+namespace test
+{
+	static const char* s_SourcePath = "res/textures/Sigil.png";
+	/* One cooked file per format, so switching doesn't load the other one's */
+	static const char* s_CookedPaths[2] = { "cache/textures/Sigil.bc1.ctex", "cache/textures/Sigil.bc3.ctex" };
+
+	CompressedTextures::CompressedTextures()
+		:	m_Format(1),
+			m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+			m_View(glm::mat4(1.0f)),
+			m_CookTime(0.0f), m_UncompressedLoadTime(0.0f), m_CompressedLoadTime(0.0f)
+	{
+		m_BatchRenderer = std::make_unique<BatchRenderer>();
+
+		if (!std::filesystem::exists(s_CookedPaths[m_Format]))
+			Cook();
+		LoadTextures();
+	}
+
+	CompressedTextures::~CompressedTextures()
+	{
+	}
+
+	void CompressedTextures::Cook()
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		CompressedImage image;
+		if (!CookCompressedImage(s_SourcePath, m_Format == 0 ? BlockFormat::BC1 : BlockFormat::BC3, 0, true, image))
+			return;
+
+		std::error_code error;
+		const char* cookedPath = s_CookedPaths[m_Format];
+		std::filesystem::create_directories(std::filesystem::path(cookedPath).parent_path(), error);
+		if (!WriteCompressedImage(cookedPath, image))
+			std::cout << "Warning: could not write '" << cookedPath << "'" << std::endl;
+
+		auto end = std::chrono::high_resolution_clock::now();
+		m_CookTime = std::chrono::duration<float, std::milli>(end - start).count();
+	}
+
+	void CompressedTextures::LoadTextures()
+	{
+		/* Full chain on both so the memory comparison is like for like */
+		TextureSpec spec;
+		spec.Filter = TextureFilter::Trilinear;
+		spec.MipLevels = 0;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		m_Uncompressed = std::make_unique<Texture>(s_SourcePath, spec);
+		auto middle = std::chrono::high_resolution_clock::now();
+		m_Compressed = std::make_unique<Texture>(s_CookedPaths[m_Format], spec);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		m_UncompressedLoadTime = std::chrono::duration<float, std::milli>(middle - start).count();
+		m_CompressedLoadTime = std::chrono::duration<float, std::milli>(end - middle).count();
+	}
+
+	void CompressedTextures::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		Renderer::SetCamera(m_Proj, m_View);
+		m_BatchRenderer->Begin();
+		m_BatchRenderer->DrawQuad(glm::vec2(250.0f, 270.0f), glm::vec2(400.0f), *m_Uncompressed);
+		m_BatchRenderer->DrawQuad(glm::vec2(710.0f, 270.0f), glm::vec2(400.0f), *m_Compressed);
+		m_BatchRenderer->End();
+	}
+
+	void CompressedTextures::OnImGuiRender()
+	{
+		const char* formats[] = { "BC1", "BC3" };
+		if (ImGui::Combo("Format", &m_Format, formats, 2))
+		{
+			if (!std::filesystem::exists(s_CookedPaths[m_Format]))
+				Cook();
+			LoadTextures();
+		}
+		if (ImGui::Button("Cook"))
+		{
+			Cook();
+			LoadTextures();
+		}
+
+		ImGui::Text("Left: RGBA8 %zu KB, loaded in %.1f ms", m_Uncompressed->GetMemorySize() / 1024, m_UncompressedLoadTime);
+		ImGui::Text("Right: %s %zu KB, loaded in %.1f ms", m_Compressed->IsCompressed() ? "compressed" : "fallback",
+			m_Compressed->GetMemorySize() / 1024, m_CompressedLoadTime);
+		if (m_Compressed->IsCompressed())
+			ImGui::Text("Saves %.1f%% of video memory", 100.0f * (1.0f - (float)m_Compressed->GetMemorySize() / m_Uncompressed->GetMemorySize()));
+		if (m_CookTime > 0.0f)
+			ImGui::Text("Cooked in %.1f ms", m_CookTime);
+		ImGui::TextWrapped("Offline: texcook [--bc1 | --bc3] input.png output.ctex");
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Test.h"
+
+#include "Texture.h"
+#include "BatchRenderer.h"
+
+#include <memory>
+
+namespace test
+{
+	/* Shows Sigil.png next to a block compressed copy cooked the same way texcook does,
+	   with the video memory and load time of each */
+	class CompressedTextures : public Test
+	{
+	private:
+		int m_Format;
+		glm::mat4 m_Proj, m_View;
+
+		std::unique_ptr<Texture> m_Uncompressed;
+		std::unique_ptr<Texture> m_Compressed;
+		std::unique_ptr<BatchRenderer> m_BatchRenderer;
+
+		float m_CookTime, m_UncompressedLoadTime, m_CompressedLoadTime;
+	public:
+		CompressedTextures();
+		~CompressedTextures();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void Cook();
+		void LoadTextures();
+	};
+}
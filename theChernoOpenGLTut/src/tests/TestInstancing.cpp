@@ -0,0 +1,100 @@
+#include "TestInstancing.h"
+
+#include "Renderer.h"
+
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cmath>
+
+namespace test
+{
+	Instancing::Instancing()
+		:	m_InstanceCount(10000), m_UploadedCount(0),
+			m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+			m_View(glm::mat4(1.0f))
+	{
+		float quadData[] =
+		{
+			-0.5f, -0.5f, 0.0f, 0.0f,
+			 0.5f, -0.5f, 1.0f, 0.0f,
+			 0.5f,  0.5f, 1.0f, 1.0f,
+			-0.5f,  0.5f, 0.0f, 1.0f,
+		};
+
+		unsigned int quadIndex[] =
+		{
+			0, 1, 2,		// triangle 1
+			2, 3, 0,		// triangle 2
+		};
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(quadData, 4 * 4 * sizeof(float));
+
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VAO->AddBuffer(*m_VBO, layout);
+
+		/* Model matrices advance once per instance */
+		m_InstanceVBO = std::make_unique<VertexBuffer>(MaxInstances * (unsigned int)sizeof(glm::mat4));
+		VertexBufferLayout instanceLayout(1);
+		instanceLayout.Push<glm::mat4>(1);
+		m_VAO->AddBuffer(*m_InstanceVBO, instanceLayout);
+
+		m_IBO = std::make_unique<IndexBuffer>(quadIndex, 6);
+
+		m_Shader = std::make_unique<Shader>("res/shaders/Basic.shader", ShaderDefines{ { "INSTANCED", "1" } });
+		m_Shader->Bind();
+		m_Shader->SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+		m_Shader->SetUniform1i("u_Texture", 0);
+
+		m_Texture = std::make_unique<Texture>("res/textures/Sigil.png");
+		m_Models.reserve(MaxInstances);
+	}
+
+	Instancing::~Instancing()
+	{
+	}
+
+	void Instancing::OnUpdate(float deltaTime)
+	{
+		if (m_InstanceCount == m_UploadedCount)
+			return;
+
+		/* Lay the sprites out in a grid that covers the window */
+		int columns = (int)std::ceil(std::sqrt(m_InstanceCount * 960.0f / 540.0f));
+		float size = 960.0f / columns;
+
+		m_Models.clear();
+		for (int i = 0; i < m_InstanceCount; i++)
+		{
+			glm::vec3 position((i % columns + 0.5f) * size, (i / columns + 0.5f) * size, 0.0f);
+			m_Models.push_back(glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), glm::vec3(size, size, 1.0f)));
+		}
+		m_InstanceVBO->SetData(m_Models.data(), (unsigned int)(m_Models.size() * sizeof(glm::mat4)));
+		m_UploadedCount = m_InstanceCount;
+	}
+
+	void Instancing::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		Renderer renderer;
+
+		Renderer::SetCamera(m_Proj, m_View);
+		m_Texture->Bind();
+		m_Shader->Bind();
+		renderer.DrawInstanced(*m_VAO, *m_IBO, *m_Shader, m_UploadedCount);
+	}
+
+	void Instancing::OnImGuiRender()
+	{
+		ImGui::SliderInt("Instances", &m_InstanceCount, 1, MaxInstances);
+		ImGui::Text("Draw calls: 1");
+		ImGui::Text("Application Average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Test.h"
+
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "Texture.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	/* Draws every sprite in one glDrawElementsInstanced, with the model matrix in a per-instance stream */
+	class Instancing : public Test
+	{
+	private:
+		static const int MaxInstances = 100000;
+
+		int m_InstanceCount;
+		int m_UploadedCount;
+		glm::mat4 m_Proj, m_View;
+
+		std::vector<glm::mat4> m_Models;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<VertexBuffer> m_InstanceVBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		std::unique_ptr<Shader> m_Shader;
+		std::unique_ptr<Texture> m_Texture;
+	public:
+		Instancing();
+		~Instancing();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+	};
+}
@@ -0,0 +1,122 @@
+#include "TestInterpolation.h"
+
+#include "Renderer.h"
+
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test
+{
+	static const float s_SpriteSize = 50.0f;
+	static const float s_Width = 960.0f;
+
+	Interpolation::Interpolation()
+		:	m_Alpha(0.0f), m_StepsThisFrame(0), m_Interpolate(true),
+			m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+			m_View(glm::mat4(1.0f))
+	{
+		float quadData[] =
+		{
+			-0.5f, -0.5f, 0.0f, 0.0f,
+			 0.5f, -0.5f, 1.0f, 0.0f,
+			 0.5f,  0.5f, 1.0f, 1.0f,
+			-0.5f,  0.5f, 0.0f, 1.0f,
+		};
+
+		unsigned int quadIndex[] =
+		{
+			0, 1, 2,		// triangle 1
+			2, 3, 0,		// triangle 2
+		};
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(quadData, 4 * 4 * sizeof(float));
+
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VAO->AddBuffer(*m_VBO, layout);
+
+		m_IBO = std::make_unique<IndexBuffer>(quadIndex, 6);
+
+		m_Shader = std::make_unique<Shader>("res/shaders/Basic.shader");
+		m_Shader->Bind();
+		m_Shader->SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+		m_Shader->SetUniform1i("u_Texture", 0);
+		m_ModelUniform = m_Shader->GetUniform<glm::mat4>(HashString("u_Model"));
+		m_Texture = std::make_unique<Texture>("res/textures/Sigil.png");
+
+		for (int i = 0; i < SpriteCount; i++)
+		{
+			m_Sprites[i].Previous = m_Sprites[i].Current = s_SpriteSize;
+			m_Sprites[i].Velocity = 200.0f * (i + 1);
+		}
+	}
+
+	Interpolation::~Interpolation()
+	{
+	}
+
+	void Interpolation::OnUpdate(float deltaTime)
+	{
+		m_StepsThisFrame = 0;
+	}
+
+	void Interpolation::OnFixedUpdate(float timestep)
+	{
+		float minX = s_SpriteSize / 2.0f, maxX = s_Width - s_SpriteSize / 2.0f;
+		for (Sprite& sprite : m_Sprites)
+		{
+			sprite.Previous = sprite.Current;
+			sprite.Current += sprite.Velocity * timestep;
+			if (sprite.Current < minX || sprite.Current > maxX)
+			{
+				sprite.Current = glm::clamp(sprite.Current, minX, maxX);
+				sprite.Velocity = -sprite.Velocity;
+			}
+		}
+		m_StepsThisFrame++;
+	}
+
+	void Interpolation::OnInterpolate(float alpha)
+	{
+		m_Alpha = alpha;
+	}
+
+	void Interpolation::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		Renderer renderer;
+		Renderer::SetCamera(m_Proj, m_View);
+
+		m_Texture->Bind();
+		m_Shader->Bind();
+
+		for (int i = 0; i < SpriteCount; i++)
+		{
+			const Sprite& sprite = m_Sprites[i];
+			float interpolated = m_Interpolate ? glm::mix(sprite.Previous, sprite.Current, m_Alpha) : sprite.Current;
+
+			/* Interpolated lanes on top, the raw simulation below */
+			float rows[2][2] = { { interpolated, 480.0f - i * 60.0f }, { sprite.Current, 220.0f - i * 60.0f } };
+			for (const float* row : rows)
+			{
+				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(row[0], row[1], 0.0f))
+					* glm::scale(glm::mat4(1.0f), glm::vec3(s_SpriteSize, s_SpriteSize, 1.0f));
+				m_Shader->SetUniform(m_ModelUniform, model);
+				renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
+			}
+		}
+	}
+
+	void Interpolation::OnImGuiRender()
+	{
+		ImGui::Checkbox("Interpolate top row", &m_Interpolate);
+		ImGui::Text("Fixed steps this frame: %d, alpha %.2f", m_StepsThisFrame, m_Alpha);
+		ImGui::Text("Application Average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
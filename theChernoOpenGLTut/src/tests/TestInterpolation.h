@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Test.h"
+
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "Texture.h"
+
+#include <memory>
+
+namespace test
+{
+	/* Sprites bouncing across the window, moved only in OnFixedUpdate. The top row is drawn
+	   between the last two steps, the bottom row where the last step left it; turn the
+	   simulation rate down in Frame Pacing to see the difference */
+	class Interpolation : public Test
+	{
+	private:
+		static const int SpriteCount = 4;
+
+		struct Sprite
+		{
+			float Previous, Current;	// x before and after the last step
+			float Velocity;				// pixels per second
+		};
+
+		Sprite m_Sprites[SpriteCount];
+		float m_Alpha;
+		int m_StepsThisFrame;
+		bool m_Interpolate;
+		glm::mat4 m_Proj, m_View;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		std::unique_ptr<Shader> m_Shader;
+		UniformHandle<glm::mat4> m_ModelUniform;
+		std::unique_ptr<Texture> m_Texture;
+	public:
+		Interpolation();
+		~Interpolation();
+
+		void OnUpdate(float deltaTime) override;
+		void OnFixedUpdate(float timestep) override;
+		void OnInterpolate(float alpha) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+	};
+}
@@ -0,0 +1,123 @@
+#include "TestMipmaps.h"
+
+#include "Renderer.h"
+
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cmath>
+
+namespace test
+{
+	enum MipMode
+	{
+		NoMips = 0,
+		GpuMips,
+		CpuMips,
+	};
+
+	Mipmaps::Mipmaps()
+		:	m_QuadCount(20000), m_QuadSize(6.0f), m_MipMode(GpuMips),
+			m_Filter((int)TextureFilter::Trilinear), m_Anisotropy(1.0f),
+			m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+			m_View(glm::mat4(1.0f)),
+			m_Queries{ 0, 0 }, m_Frame(0), m_GpuTime(0.0f)
+	{
+		m_BatchRenderer = std::make_unique<BatchRenderer>();
+		GLCall(glGenQueries(2, m_Queries));
+		CreateTexture();
+	}
+
+	Mipmaps::~Mipmaps()
+	{
+		GLCall(glDeleteQueries(2, m_Queries));
+	}
+
+	void Mipmaps::CreateTexture()
+	{
+		TextureSpec spec;
+		spec.Filter = (TextureFilter)m_Filter;
+		spec.MipLevels = m_MipMode == NoMips ? 1 : 0;
+		spec.Anisotropy = m_Anisotropy;
+
+		m_Loader.reset();
+		if (m_MipMode == CpuMips)
+		{
+			m_Loader = std::make_unique<TextureLoader>(1);
+			m_Texture = m_Loader->Load("res/textures/Sigil.png", spec);
+		}
+		else
+			m_Texture = std::make_shared<Texture>("res/textures/Sigil.png", spec);
+	}
+
+	void Mipmaps::OnUpdate(float deltaTime)
+	{
+		if (m_Loader)
+			m_Loader->Update();
+	}
+
+	void Mipmaps::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		/* Collect the query issued two frames ago if the GPU has finished it */
+		unsigned int query = m_Queries[m_Frame % 2];
+		if (m_Frame >= 2)
+		{
+			int available = 0;
+			GLCall(glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available));
+			if (available)
+			{
+				GLuint64 elapsed = 0;
+				GLCall(glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed));
+				m_GpuTime = m_GpuTime * 0.9f + (elapsed / 1000000.0f) * 0.1f;
+			}
+		}
+
+		/* Scatter the quads so neighbouring ones sample unrelated parts of the texture */
+		int columns = (int)(960.0f / m_QuadSize);
+		Renderer::SetCamera(m_Proj, m_View);
+
+		GLCall(glBeginQuery(GL_TIME_ELAPSED, query));
+		m_BatchRenderer->Begin();
+		for (int i = 0; i < m_QuadCount; i++)
+		{
+			glm::vec3 position(((i % columns) + 0.5f) * m_QuadSize, ((i / columns) % (int)(540.0f / m_QuadSize) + 0.5f) * m_QuadSize, 0.0f);
+			glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
+				* glm::rotate(glm::mat4(1.0f), i * 0.37f, glm::vec3(0.0f, 0.0f, 1.0f))
+				* glm::scale(glm::mat4(1.0f), glm::vec3(m_QuadSize, m_QuadSize, 1.0f));
+			m_BatchRenderer->DrawQuad(transform, *m_Texture);
+		}
+		m_BatchRenderer->End();
+		GLCall(glEndQuery(GL_TIME_ELAPSED));
+
+		m_Frame++;
+	}
+
+	void Mipmaps::OnImGuiRender()
+	{
+		const char* mipModes[] = { "No mips", "glGenerateMipmap", "CPU box filter (loader)" };
+		const char* filters[] = { "Nearest", "Bilinear", "Trilinear" };
+
+		ImGui::SliderInt("Quads", &m_QuadCount, 1, 100000);
+		ImGui::SliderFloat("Quad size (px)", &m_QuadSize, 1.0f, 64.0f);
+
+		bool changed = ImGui::Combo("Mips", &m_MipMode, mipModes, 3);
+		changed |= ImGui::Combo("Filter", &m_Filter, filters, 3);
+		changed |= ImGui::SliderFloat("Anisotropy", &m_Anisotropy, 1.0f, 16.0f);
+		if (changed)
+			CreateTexture();
+
+		ImGui::Text("Texture %dx%d, %u levels%s", m_Texture->GetWidth(), m_Texture->GetHeight(),
+			m_Texture->GetMipLevels(), m_Texture->IsReady() ? "" : " (loading)");
+		ImGui::Text("Anisotropic filtering: %s", GLEW_EXT_texture_filter_anisotropic ? "supported" : "not supported");
+
+		/* Screen pixels covered, each one samples the texture once */
+		float pixels = m_QuadCount * m_QuadSize * m_QuadSize;
+		ImGui::Text("GPU %.3f ms (%.0f Mpixels/s)", m_GpuTime, m_GpuTime > 0.0f ? pixels / (m_GpuTime * 1000.0f) : 0.0f);
+		ImGui::Text("Application Average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
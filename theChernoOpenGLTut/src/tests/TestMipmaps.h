@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Test.h"
+
+#include "Texture.h"
+#include "TextureLoader.h"
+#include "BatchRenderer.h"
+
+#include <memory>
+
+namespace test
+{
+	/* Draws a 2000x2000 texture onto thousands of tiny quads and times the GPU,
+	   comparing no mips, glGenerateMipmap and the TextureLoader's CPU box filter */
+	class Mipmaps : public Test
+	{
+	private:
+		int m_QuadCount;
+		float m_QuadSize;
+		int m_MipMode;
+		int m_Filter;
+		float m_Anisotropy;
+		glm::mat4 m_Proj, m_View;
+
+		std::unique_ptr<TextureLoader> m_Loader;
+		std::shared_ptr<Texture> m_Texture;
+		std::unique_ptr<BatchRenderer> m_BatchRenderer;
+
+		/* GL_TIME_ELAPSED queries, alternated so reading one never waits on the GPU */
+		unsigned int m_Queries[2];
+		unsigned int m_Frame;
+		float m_GpuTime;
+	public:
+		Mipmaps();
+		~Mipmaps();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void CreateTexture();
+	};
+}
@@ -0,0 +1,179 @@
+#include "TestRenderToTexture.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuProfiler.h"
+#include "ImageWriter.h"
+
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cstdio>
+#include <filesystem>
+
+namespace test
+{
+	static const unsigned int s_SampleCounts[] = { 1, 2, 4, 8 };
+	static const char* s_SampleNames[] = { "Off", "2x", "4x", "8x" };
+	static const int s_BarCount = 12;
+
+	RenderToTexture::RenderToTexture()
+		:	m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+			m_View(1.0f), m_SampleIndex(2), m_Scale(1.0f), m_Angle(0.0f),
+			m_ReadbackFrames(0), m_CentrePixel{ 0, 0, 0, 0 }, m_Recording(false)
+	{
+		float quad[] =
+		{
+			-0.5f, -0.5f, 0.0f, 0.0f,
+			 0.5f, -0.5f, 1.0f, 0.0f,
+			 0.5f,  0.5f, 1.0f, 1.0f,
+			-0.5f,  0.5f, 0.0f, 1.0f,
+		};
+
+		unsigned int indices[] =
+		{
+			0, 1, 2,
+			2, 3, 0,
+		};
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(quad, 4 * 4 * sizeof(float));
+
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VAO->AddBuffer(*m_VBO, layout);
+
+		m_IBO = std::make_unique<IndexBuffer>(indices, 6);
+
+		m_ColourShader = std::make_unique<Shader>("res/shaders/Basic.shader", ShaderDefines{ { "FLAT_COLOUR", "1" } });
+		m_ColourModelUniform = m_ColourShader->GetUniform<glm::mat4>(HashString("u_Model"));
+		m_ColourUniform = m_ColourShader->GetUniform<glm::vec4>(HashString("u_Color"));
+
+		m_TextureShader = std::make_unique<Shader>("res/shaders/Basic.shader");
+		m_TextureShader->Bind();
+		m_TextureShader->SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+		m_TextureShader->SetUniform1i("u_Texture", 0);
+		m_TextureModelUniform = m_TextureShader->GetUniform<glm::mat4>(HashString("u_Model"));
+
+		FramebufferSpec spec;
+		spec.Samples = s_SampleCounts[m_SampleIndex];
+		m_Framebuffer = std::make_unique<Framebuffer>(960, 540, spec);
+	}
+
+	RenderToTexture::~RenderToTexture()
+	{
+	}
+
+	void RenderToTexture::OnRender()
+	{
+		/* Sample count is fixed at creation, size changes go through Resize */
+		int width = (int)(960 * m_Scale), height = (int)(540 * m_Scale);
+		if (m_Framebuffer->GetSpec().Samples != s_SampleCounts[m_SampleIndex])
+		{
+			FramebufferSpec spec;
+			spec.Samples = s_SampleCounts[m_SampleIndex];
+			m_Framebuffer = std::make_unique<Framebuffer>(width, height, spec);
+		}
+		else
+		{
+			m_Framebuffer->Resize(width, height);
+		}
+
+		Renderer renderer;
+		Renderer::SetCamera(m_Proj, m_View);
+
+		{
+			GPU_PROFILE_SCOPE("Scene");
+			m_Framebuffer->Bind();
+			GLCall(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+			renderer.Clear();
+
+			m_ColourShader->Bind();
+			for (int i = 0; i < s_BarCount; i++)
+			{
+				float angle = glm::radians(m_Angle + i * 180.0f / s_BarCount);
+				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(480.0f, 270.0f, 0.0f));
+				model = glm::rotate(model, angle, glm::vec3(0.0f, 0.0f, 1.0f));
+				model = glm::scale(model, glm::vec3(480.0f, 3.0f, 1.0f));
+
+				float t = (float)i / s_BarCount;
+				m_ColourShader->SetUniform(m_ColourModelUniform, model);
+				m_ColourShader->SetUniform(m_ColourUniform, glm::vec4(1.0f - t, 0.4f + 0.6f * t, t, 1.0f));
+				renderer.Draw(*m_VAO, *m_IBO, *m_ColourShader);
+			}
+
+			m_Framebuffer->Unbind();
+		}
+
+		{
+			GPU_PROFILE_SCOPE("Resolve");
+			m_Framebuffer->Resolve();
+		}
+
+		{
+			/* Stretch the resolved colour over whatever was bound before */
+			GPU_PROFILE_SCOPE("Composite");
+			StateCache::Get().BindTexture2D(0, m_Framebuffer->GetColourAttachment());
+			glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(480.0f, 270.0f, 0.0f));
+			model = glm::scale(model, glm::vec3(960.0f, 540.0f, 1.0f));
+			m_TextureShader->Bind();
+			m_TextureShader->SetUniform(m_TextureModelUniform, model);
+			renderer.Draw(*m_VAO, *m_IBO, *m_TextureShader);
+		}
+
+		if (m_Framebuffer->IsReadbackPending())
+		{
+			m_ReadbackFrames++;
+			if (m_Framebuffer->TryGetReadback(m_Readback))
+			{
+				size_t centre = ((size_t)(height / 2) * width + width / 2) * 4;
+				for (int i = 0; i < 4; i++)
+					m_CentrePixel[i] = m_Readback[centre + i];
+			}
+		}
+
+		if (m_Recording)
+			m_Recorder->Capture(*m_Framebuffer);
+		if (m_Recorder)
+			m_Recorder->Update();
+	}
+
+	void RenderToTexture::OnImGuiRender()
+	{
+		ImGui::Combo("MSAA", &m_SampleIndex, s_SampleNames, IM_ARRAYSIZE(s_SampleNames));
+		ImGui::SliderFloat("Resolution", &m_Scale, 0.1f, 2.0f);
+		ImGui::SliderFloat("Angle", &m_Angle, 0.0f, 180.0f);
+		ImGui::Text("Target %dx%d, %u samples", m_Framebuffer->GetWidth(), m_Framebuffer->GetHeight(), m_Framebuffer->GetSamples());
+
+		if (ImGui::Button("Read back"))
+		{
+			m_Framebuffer->BeginReadback();
+			m_Readback.clear();
+			m_ReadbackFrames = 0;
+		}
+		if (ImGui::Checkbox("Record", &m_Recording) && m_Recording && !m_Recorder)
+		{
+			std::filesystem::create_directories("cache/frames");
+			m_Recorder = std::make_unique<ReadbackQueue>(3, [](const ReadbackQueue::Frame& frame)
+			{
+				char path[64];
+				std::snprintf(path, sizeof(path), "cache/frames/frame_%05llu.png", (unsigned long long)frame.Index);
+				WritePNG(path, frame.Pixels.data(), frame.Width, frame.Height);
+			});
+		}
+		if (m_Recorder)
+		{
+			ReadbackQueue::Stats stats = m_Recorder->GetStats();
+			ImGui::Text("Frames captured %u, written %u, dropped %u", stats.Captured, stats.Delivered, stats.Dropped);
+		}
+
+		if (m_Framebuffer->IsReadbackPending())
+			ImGui::Text("Waiting for readback, %d frames so far", m_ReadbackFrames);
+		else if (!m_Readback.empty())
+			ImGui::Text("Arrived after %d frames, centre pixel %u %u %u %u", m_ReadbackFrames,
+				m_CentrePixel[0], m_CentrePixel[1], m_CentrePixel[2], m_CentrePixel[3]);
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Test.h"
+
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "Framebuffer.h"
+#include "ReadbackQueue.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	/* Draws thin rotated bars into a Framebuffer at a chosen sample count and resolution,
+	   then stretches the resolved texture over the window. Readback shows how many frames
+	   a fenced copy takes to arrive, Record dumps every frame to cache/frames as PNGs */
+	class RenderToTexture : public Test
+	{
+	private:
+		glm::mat4 m_Proj, m_View;
+		int m_SampleIndex;
+		float m_Scale, m_Angle;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		std::unique_ptr<Shader> m_ColourShader, m_TextureShader;
+		UniformHandle<glm::mat4> m_ColourModelUniform, m_TextureModelUniform;
+		UniformHandle<glm::vec4> m_ColourUniform;
+		std::unique_ptr<Framebuffer> m_Framebuffer;
+
+		std::vector<unsigned char> m_Readback;
+		int m_ReadbackFrames;
+		unsigned char m_CentrePixel[4];
+
+		bool m_Recording;
+		std::unique_ptr<ReadbackQueue> m_Recorder;
+	public:
+		RenderToTexture();
+		~RenderToTexture();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+	};
+}
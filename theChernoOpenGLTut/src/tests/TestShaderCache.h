@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Test.h"
+
+namespace test
+{
+	/* Times shader construction with the program binary cache off (cold) and on (warm) */
+	class ShaderCache : public Test
+	{
+	private:
+		int m_Iterations;
+		float m_ColdTime, m_WarmTime;
+	public:
+		ShaderCache();
+		~ShaderCache();
+
+		void OnImGuiRender() override;
+
+	private:
+		float TimeShaderLoads(bool useCache);
+	};
+}
@@ -0,0 +1,136 @@
+#include "TestShaderLibrary.h"
+
+#include "Renderer.h"
+
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+
+namespace test
+{
+	TestShaderLibrary::TestShaderLibrary()
+		:	m_VariantCount(32), m_DistinctCount(32), m_BypassCache(true),
+			m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+			m_View(glm::mat4(1.0f)),
+			m_SubmitDuration(0.0f), m_CompileDuration(0.0f), m_WorstFrame(0.0f)
+	{
+		float imageData[] =
+		{
+			-100.0f, -100.0f, 0.0f, 0.0f,
+			 100.0f, -100.0f, 1.0f, 0.0f,
+			 100.0f,  100.0f, 1.0f, 1.0f,
+			-100.0f,  100.0f, 0.0f, 1.0f,
+		};
+
+		unsigned int imageIndex[] =
+		{
+			0, 1, 2,		// triangle 1
+			2, 3, 0,		// triangle 2
+		};
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(imageData, 4 * 4 * sizeof(float));
+
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VAO->AddBuffer(*m_VBO, layout);
+
+		m_IBO = std::make_unique<IndexBuffer>(imageIndex, 6);
+		m_Texture = std::make_unique<Texture>("res/textures/Sigil.png");
+
+		m_LastFrame = std::chrono::high_resolution_clock::now();
+		Submit();
+	}
+
+	TestShaderLibrary::~TestShaderLibrary()
+	{
+	}
+
+	void TestShaderLibrary::Submit()
+	{
+		bool wasEnabled = Shader::IsProgramCacheEnabled();
+		Shader::SetProgramCacheEnabled(!m_BypassCache);
+
+		m_SubmitTime = std::chrono::high_resolution_clock::now();
+		m_Library = std::make_unique<ShaderLibrary>();
+		m_Variants.clear();
+
+		/* Each VARIANT value makes a distinct program the driver has to compile from scratch,
+		   repeated values share the program, and UNUSED is dropped since Basic.shader never reads it */
+		for (int i = 0; i < m_VariantCount; i++)
+		{
+			ShaderDefines defines;
+			defines["VARIANT"] = std::to_string(i % m_DistinctCount);
+			defines["UNUSED"] = std::to_string(i);
+			m_Variants.push_back(m_Library->Load("Basic" + std::to_string(i), "res/shaders/Basic.shader", defines));
+		}
+
+		auto end = std::chrono::high_resolution_clock::now();
+		m_SubmitDuration = std::chrono::duration<float, std::milli>(end - m_SubmitTime).count();
+		m_CompileDuration = 0.0f;
+		m_WorstFrame = 0.0f;
+
+		Shader::SetProgramCacheEnabled(wasEnabled);
+	}
+
+	void TestShaderLibrary::OnUpdate(float deltaTime)
+	{
+		auto now = std::chrono::high_resolution_clock::now();
+		float frameTime = std::chrono::duration<float, std::milli>(now - m_LastFrame).count();
+		m_LastFrame = now;
+
+		if (m_Library->GetPendingCount() == 0)
+			return;
+
+		m_WorstFrame = std::max(m_WorstFrame, frameTime);
+		m_Library->Update();
+		if (m_Library->GetPendingCount() == 0)
+			m_CompileDuration = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - m_SubmitTime).count();
+	}
+
+	void TestShaderLibrary::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		Renderer renderer;
+		Renderer::SetCamera(m_Proj, m_View);
+		m_Texture->Bind();
+
+		/* Draw one quad per variant that has finished compiling */
+		for (size_t i = 0; i < m_Variants.size(); i++)
+		{
+			ShaderHandle& variant = m_Variants[i];
+			if (!variant.IsReady())
+				continue;
+
+			glm::vec3 position(120.0f + (i % 8) * 100.0f, 100.0f + (i / 8 % 4) * 110.0f, 0.0f);
+			glm::mat4 model = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), glm::vec3(0.4f));
+			variant->Bind();
+			variant->SetUniformMat4f("u_Model", model);
+			variant->SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+			variant->SetUniform1i("u_Texture", 0);
+			renderer.Draw(*m_VAO, *m_IBO, variant.Get());
+		}
+	}
+
+	void TestShaderLibrary::OnImGuiRender()
+	{
+		ImGui::SliderInt("Variants", &m_VariantCount, 1, 32);
+		ImGui::SliderInt("Distinct", &m_DistinctCount, 1, 32);
+		ImGui::Checkbox("Bypass program cache", &m_BypassCache);
+		if (ImGui::Button("Submit"))
+			Submit();
+
+		ImGui::Text("Parallel compile: %s", Shader::IsParallelCompileSupported() ? "KHR/ARB_parallel_shader_compile" : "not supported, one shader per frame");
+		ImGui::Text("Pending: %u / %u", m_Library->GetPendingCount(), m_Library->GetProgramCount());
+		ImGui::Text("%u variants share %u programs", m_Library->GetShaderCount(), m_Library->GetProgramCount());
+		ImGui::Text("Submit %.3f ms, all ready after %.3f ms", m_SubmitDuration, m_CompileDuration);
+		ImGui::Text("Worst frame while compiling %.3f ms", m_WorstFrame);
+		ImGui::Text("Application Average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Test.h"
+
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "Texture.h"
+#include "ShaderLibrary.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	/* Submits a set of shader variants at once and keeps rendering while the driver compiles them */
+	class TestShaderLibrary : public Test
+	{
+	private:
+		int m_VariantCount, m_DistinctCount;
+		bool m_BypassCache;
+		glm::mat4 m_Proj, m_View;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		std::unique_ptr<Texture> m_Texture;
+
+		std::unique_ptr<ShaderLibrary> m_Library;
+		std::vector<ShaderHandle> m_Variants;
+
+		std::chrono::high_resolution_clock::time_point m_SubmitTime, m_LastFrame;
+		float m_SubmitDuration, m_CompileDuration, m_WorstFrame;
+	public:
+		TestShaderLibrary();
+		~TestShaderLibrary();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void Submit();
+	};
+}
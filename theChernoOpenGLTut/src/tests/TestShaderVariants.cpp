@@ -0,0 +1,132 @@
+#include "TestShaderVariants.h"
+
+#include "Renderer.h"
+
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test
+{
+	ShaderVariants::ShaderVariants()
+		:	m_Instanced(false), m_FlatColour(false), m_AlphaTest(false),
+			m_AlphaCutoff(0.5f), m_Colour(1.0f),
+			m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+			m_View(glm::mat4(1.0f))
+	{
+		float quadData[] =
+		{
+			-0.5f, -0.5f, 0.0f, 0.0f,
+			 0.5f, -0.5f, 1.0f, 0.0f,
+			 0.5f,  0.5f, 1.0f, 1.0f,
+			-0.5f,  0.5f, 0.0f, 1.0f,
+		};
+
+		unsigned int quadIndex[] =
+		{
+			0, 1, 2,		// triangle 1
+			2, 3, 0,		// triangle 2
+		};
+
+		/* The same models feed both the per-instance stream and u_Model */
+		float size = 960.0f / Columns;
+		for (int i = 0; i < Columns * Rows; i++)
+		{
+			glm::vec3 position((i % Columns + 0.5f) * size, (i / Columns + 0.5f) * size, 0.0f);
+			m_Models.push_back(glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), glm::vec3(size * 0.9f, size * 0.9f, 1.0f)));
+		}
+
+		m_VAO = std::make_unique<VertexArray>();
+		m_VBO = std::make_unique<VertexBuffer>(quadData, 4 * 4 * sizeof(float));
+
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VAO->AddBuffer(*m_VBO, layout);
+
+		m_InstanceVBO = std::make_unique<VertexBuffer>(m_Models.data(), (unsigned int)(m_Models.size() * sizeof(glm::mat4)));
+		VertexBufferLayout instanceLayout(1);
+		instanceLayout.Push<glm::mat4>(1);
+		m_VAO->AddBuffer(*m_InstanceVBO, instanceLayout);
+
+		m_IBO = std::make_unique<IndexBuffer>(quadIndex, 6);
+		m_Texture = std::make_unique<Texture>("res/textures/Sigil.png");
+
+		/* Nothing is compiled here, only the keywords are declared */
+		m_Variants = std::make_unique<ShaderVariantSet>("res/shaders/Basic.shader");
+		m_InstancedKeyword = m_Variants->AddKeyword("INSTANCED");
+		m_FlatColourKeyword = m_Variants->AddKeyword("FLAT_COLOUR");
+		m_AlphaKeyword = m_Variants->AddKeyword("ALPHA", { "OPAQUE", "TEST" });
+	}
+
+	ShaderVariants::~ShaderVariants()
+	{
+	}
+
+	ShaderVariantKey ShaderVariants::GetSelectedKey() const
+	{
+		ShaderVariantKey key = 0;
+		key = m_Variants->Select(key, m_InstancedKeyword, m_Instanced);
+		key = m_Variants->Select(key, m_FlatColourKeyword, m_FlatColour);
+		key = m_Variants->Select(key, m_AlphaKeyword, m_AlphaTest);
+		return key;
+	}
+
+	void ShaderVariants::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		Renderer renderer;
+		Renderer::SetCamera(m_Proj, m_View);
+
+		Shader& shader = m_Variants->Get(GetSelectedKey());
+		shader.Bind();
+		shader.SetUniform4f("u_Color", m_Colour.r, m_Colour.g, m_Colour.b, m_Colour.a);
+		if (!m_FlatColour)
+		{
+			m_Texture->Bind();
+			shader.SetUniform1i("u_Texture", 0);
+		}
+		if (m_AlphaTest)
+		{
+			UniformHandle<float> cutoff = shader.GetUniform<float>(HashString("u_AlphaCutoff"));
+			shader.SetUniform(cutoff, m_AlphaCutoff);
+		}
+
+		if (m_Instanced)
+		{
+			renderer.DrawInstanced(*m_VAO, *m_IBO, shader, (unsigned int)m_Models.size());
+		}
+		else
+		{
+			for (const glm::mat4& model : m_Models)
+			{
+				shader.SetUniformMat4f("u_Model", model);
+				renderer.Draw(*m_VAO, *m_IBO, shader);
+			}
+		}
+	}
+
+	void ShaderVariants::OnImGuiRender()
+	{
+		ImGui::Checkbox("INSTANCED", &m_Instanced);
+		ImGui::Checkbox("FLAT_COLOUR", &m_FlatColour);
+		ImGui::Checkbox("ALPHA_TEST", &m_AlphaTest);
+		ImGui::SliderFloat("Alpha cutoff", &m_AlphaCutoff, 0.0f, 1.0f);
+		ImGui::ColorEdit4("Colour", &m_Colour.x);
+
+		const ShaderVariantSet::Stats& stats = m_Variants->GetStats();
+		ImGui::Text("Permutations compiled: %u of %u (%u programs)", stats.Compiled, m_Variants->GetPermutationCount(), m_Variants->GetProgramCount());
+		ImGui::Text("Time spent building permutations: %.1f ms", stats.CompileTime);
+		for (ShaderVariantKey key : m_Variants->GetPermutationKeys())
+		{
+			std::string name;
+			for (const auto& define : m_Variants->GetDefines(key))
+				name += define.first + " ";
+			ImGui::Text("%s %s", m_Variants->IsCompiled(key) ? "[x]" : "[ ]", name.empty() ? "(default)" : name.c_str());
+		}
+		ImGui::Text("Application Average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
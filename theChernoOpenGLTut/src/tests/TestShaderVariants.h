@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Test.h"
+
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "Texture.h"
+#include "ShaderVariantSet.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	/* Draws a grid of sprites with the Basic.shader permutation picked by the keyword
+	   checkboxes, compiling each permutation the first time it is selected */
+	class ShaderVariants : public Test
+	{
+	private:
+		static const int Columns = 8, Rows = 4;
+
+		bool m_Instanced, m_FlatColour, m_AlphaTest;
+		float m_AlphaCutoff;
+		glm::vec4 m_Colour;
+		glm::mat4 m_Proj, m_View;
+
+		std::vector<glm::mat4> m_Models;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<VertexBuffer> m_InstanceVBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		std::unique_ptr<Texture> m_Texture;
+
+		std::unique_ptr<ShaderVariantSet> m_Variants;
+		unsigned int m_InstancedKeyword, m_FlatColourKeyword, m_AlphaKeyword;
+	public:
+		ShaderVariants();
+		~ShaderVariants();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		ShaderVariantKey GetSelectedKey() const;
+	};
+}
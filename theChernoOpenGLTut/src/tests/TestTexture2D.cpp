@@ -47,6 +47,7 @@ namespace test
 		m_Shader->SetUniform4f("u_Color", 0.8f, 0.3f, 0.8f, 1.0f);
 		m_Texture = std::make_unique<Texture>("res/textures/Sigil.png");
 		m_Shader->SetUniform1i("u_Texture", 0);
+		m_ModelUniform = m_Shader->GetUniform<glm::mat4>(HashString("u_Model"));
 	}
 
 	Texture2D::~Texture2D()
@@ -63,22 +64,21 @@ namespace test
 		GLCall(glClear(GL_COLOR_BUFFER_BIT));
 
 		Renderer renderer;
+		Renderer::SetCamera(m_Proj, m_View);
 
 		m_Texture->Bind();
 
 		{
 			glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationA);
-			glm::mat4 mvp = m_Proj * m_View * model;
 			m_Shader->Bind();
-			m_Shader->SetUniformMat4f("u_MVP", mvp);
+			m_Shader->SetUniform(m_ModelUniform, model);
 			renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
 		}
 
 		{
 			glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationB);
-			glm::mat4 mvp = m_Proj * m_View * model;
 			m_Shader->Bind();
-			m_Shader->SetUniformMat4f("u_MVP", mvp);
+			m_Shader->SetUniform(m_ModelUniform, model);
 			renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
 		}
 	}
@@ -20,6 +20,7 @@ namespace test
 		std::unique_ptr<VertexBuffer> m_VBO;
 		std::unique_ptr<IndexBuffer> m_IBO;
 		std::unique_ptr<Shader> m_Shader;
+		UniformHandle<glm::mat4> m_ModelUniform;
 		std::unique_ptr<Texture> m_Texture;
 	public:
 		Texture2D();
@@ -0,0 +1,111 @@
+#include "TestTextureStreaming.h"
+
+#include "Renderer.h"
+
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace test
+{
+	TextureStreaming::TextureStreaming()
+		:	m_TextureCount(200), m_UploadBudgetKB(4096), m_Async(true),
+			m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+			m_View(glm::mat4(1.0f)),
+			m_LoadDuration(0.0f), m_WorstFrame(0.0f), m_Loading(false)
+	{
+		m_BatchRenderer = std::make_unique<BatchRenderer>();
+		m_LastFrame = std::chrono::high_resolution_clock::now();
+	}
+
+	TextureStreaming::~TextureStreaming()
+	{
+	}
+
+	void TextureStreaming::Load()
+	{
+		/* Destroying the old loader first stops its workers before the textures go */
+		m_Loader.reset();
+		m_Textures.clear();
+
+		m_LoadStart = std::chrono::high_resolution_clock::now();
+		m_LoadDuration = 0.0f;
+		m_WorstFrame = 0.0f;
+		m_Loading = true;
+
+		if (m_Async)
+		{
+			m_Loader = std::make_unique<TextureLoader>(0, m_UploadBudgetKB * 1024);
+			for (int i = 0; i < m_TextureCount; i++)
+				m_Textures.push_back(m_Loader->Load("res/textures/Sigil.png"));
+		}
+		else
+		{
+			for (int i = 0; i < m_TextureCount; i++)
+				m_Textures.push_back(std::make_shared<Texture>("res/textures/Sigil.png"));
+		}
+	}
+
+	void TextureStreaming::OnUpdate(float deltaTime)
+	{
+		auto now = std::chrono::high_resolution_clock::now();
+		float frameTime = std::chrono::duration<float, std::milli>(now - m_LastFrame).count();
+		m_LastFrame = now;
+
+		if (!m_Loading)
+			return;
+
+		m_WorstFrame = std::max(m_WorstFrame, frameTime);
+		if (m_Loader)
+		{
+			m_Loader->SetUploadBudget(m_UploadBudgetKB * 1024);
+			m_Loader->Update();
+		}
+
+		if (!m_Loader || m_Loader->GetPendingCount() == 0)
+		{
+			m_LoadDuration = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - m_LoadStart).count();
+			m_Loading = false;
+		}
+	}
+
+	void TextureStreaming::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+		if (m_Textures.empty())
+			return;
+
+		int columns = (int)std::ceil(std::sqrt(m_Textures.size() * 960.0f / 540.0f));
+		float size = 960.0f / columns;
+
+		Renderer::SetCamera(m_Proj, m_View);
+		m_BatchRenderer->Begin();
+		for (size_t i = 0; i < m_Textures.size(); i++)
+		{
+			glm::vec2 position((i % columns + 0.5f) * size, (i / columns + 0.5f) * size);
+			m_BatchRenderer->DrawQuad(position, glm::vec2(size * 0.9f), *m_Textures[i]);
+		}
+		m_BatchRenderer->End();
+	}
+
+	void TextureStreaming::OnImGuiRender()
+	{
+		ImGui::SliderInt("Textures", &m_TextureCount, 1, 500);
+		ImGui::Checkbox("Asynchronous", &m_Async);
+		ImGui::SliderInt("Upload budget (KB/frame)", &m_UploadBudgetKB, 64, 16384);
+		if (ImGui::Button("Load"))
+			Load();
+
+		if (m_Loader)
+			ImGui::Text("Decode threads: %u, pending: %u", m_Loader->GetThreadCount(), m_Loader->GetPendingCount());
+		ImGui::Text("Worst frame while loading %.3f ms", m_WorstFrame);
+		ImGui::Text("All loaded after %.3f ms", m_LoadDuration);
+		ImGui::Text("Application Average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Test.h"
+
+#include "Texture.h"
+#include "TextureLoader.h"
+#include "BatchRenderer.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	/* Loads hundreds of textures at once, either synchronously or through the TextureLoader,
+	   and reports the worst frame while they come in */
+	class TextureStreaming : public Test
+	{
+	private:
+		int m_TextureCount;
+		int m_UploadBudgetKB;
+		bool m_Async;
+		glm::mat4 m_Proj, m_View;
+
+		std::unique_ptr<TextureLoader> m_Loader;
+		std::unique_ptr<BatchRenderer> m_BatchRenderer;
+		std::vector<std::shared_ptr<Texture>> m_Textures;
+
+		std::chrono::high_resolution_clock::time_point m_LoadStart, m_LastFrame;
+		float m_LoadDuration, m_WorstFrame;
+		bool m_Loading;
+	public:
+		TextureStreaming();
+		~TextureStreaming();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void Load();
+	};
+}
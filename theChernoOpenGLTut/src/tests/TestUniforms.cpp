@@ -0,0 +1,57 @@
+#include "TestUniforms.h"
+
+#include "Renderer.h"
+
+#include "imgui/imgui.h"
+
+#include <chrono>
+
+namespace test
+{
+	Uniforms::Uniforms()
+		: m_Iterations(100000), m_StringTime(0.0f), m_HandleTime(0.0f)
+	{
+		m_Shader = std::make_unique<Shader>("res/shaders/Basic.shader");
+		m_ModelUniform = m_Shader->GetUniform<glm::mat4>(HashString("u_Model"));
+	}
+
+	Uniforms::~Uniforms()
+	{
+	}
+
+	void Uniforms::Run()
+	{
+		m_Shader->Bind();
+		glm::mat4 model(1.0f);
+
+		/* Both loops pay for the same glUniformMatrix4fv, the difference is the lookup */
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < m_Iterations; i++)
+		{
+			model[3][0] = (float)i;
+			m_Shader->SetUniformMat4f("u_Model", model);
+		}
+		auto middle = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < m_Iterations; i++)
+		{
+			model[3][0] = (float)i;
+			m_Shader->SetUniform(m_ModelUniform, model);
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+
+		m_StringTime = std::chrono::duration<float, std::milli>(middle - start).count();
+		m_HandleTime = std::chrono::duration<float, std::milli>(end - middle).count();
+	}
+
+	void Uniforms::OnImGuiRender()
+	{
+		ImGui::SliderInt("Iterations", &m_Iterations, 1000, 1000000);
+		if (ImGui::Button("Run"))
+			Run();
+
+		ImGui::Text("By name:   %.3f ms (%.1f ns per set)", m_StringTime, m_StringTime * 1e6f / m_Iterations);
+		ImGui::Text("By handle: %.3f ms (%.1f ns per set)", m_HandleTime, m_HandleTime * 1e6f / m_Iterations);
+		if (m_HandleTime > 0.0f)
+			ImGui::Text("Speedup: %.2fx", m_StringTime / m_HandleTime);
+	}
+}
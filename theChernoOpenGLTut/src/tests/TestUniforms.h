@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Test.h"
+
+#include "Shader.h"
+
+#include <memory>
+
+namespace test
+{
+	/* Times setting a uniform by name against setting it through a pre-resolved UniformHandle */
+	class Uniforms : public Test
+	{
+	private:
+		int m_Iterations;
+		float m_StringTime, m_HandleTime;
+
+		std::unique_ptr<Shader> m_Shader;
+		UniformHandle<glm::mat4> m_ModelUniform;
+	public:
+		Uniforms();
+		~Uniforms();
+
+		void OnImGuiRender() override;
+
+	private:
+		void Run();
+	};
+}
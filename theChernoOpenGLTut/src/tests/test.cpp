@@ -17,4 +17,22 @@ namespace test
 				m_CurrentTest = test.second();
 		}
 	}
+
+	Test* TestMenu::CreateTest(const std::string& name) const
+	{
+		for (auto& test : m_Tests)
+		{
+			if (test.first == name)
+				return test.second();
+		}
+		return nullptr;
+	}
+
+	std::vector<std::string> TestMenu::GetTestNames() const
+	{
+		std::vector<std::string> names;
+		for (auto& test : m_Tests)
+			names.push_back(test.first);
+		return names;
+	}
 }
\ No newline at end of file